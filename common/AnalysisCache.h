@@ -0,0 +1,186 @@
+// ============================================================
+// 文法分析缓存
+// 功能：把FIRST/FOLLOW集、LL(1)分析表、LR(1)分析表等由文法计算出的结果
+//       保存在一个缓存文件中，下次启动时文法未变就直接读取，跳过文法分析
+// 使用者：实验二LLparser.h（"ll1"区段）、实验三LRparser.h（"lr1"区段）、
+//         first_follow_tool（"ff"区段）、table_visualizer（"lr1table"区段）
+// 缓存文件位置：环境变量GRAMMAR_CACHE指定，未设置时为可执行文件旁边的"<程序名>.gcache"
+// 文件格式（本机字节序，只在同一台机器上使用）：
+//   "GAC1" | 版本(u32) | 分析器修订号(u32) | 文法散列(u64) | 区段数(u32) |
+//   每个区段：名称长度(u64) 名称 | 数据长度(u64) 数据
+// 文法散列不同、分析器修订号不同、版本不同或文件损坏时整个缓存作废，由使用者重新计算后写回
+// ============================================================
+#ifndef ANALYSIS_CACHE_H
+#define ANALYSIS_CACHE_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+// 分析器修订号：修改FIRST/FOLLOW集（FirstFollow.h）、LL(1)分析表（LLparser.h）、
+// LR(1)分析表（LRparser.h、table_visualizer）的构造代码时加1，即使区段格式不变，
+// 旧代码算出的结果也不会被新代码读到
+static const uint32_t analysisRevision = 1;
+
+// 向缓存区段追加定长整数和整数数组
+class CacheWriter {
+public:
+    std::string data;
+
+    template <class T>
+    void put(T value) {
+        data.append((const char*)&value, sizeof(value));
+    }
+
+    template <class T>
+    void putArray(const std::vector<T>& values) {
+        put((uint64_t)values.size());
+        if (!values.empty()) {
+            data.append((const char*)values.data(), values.size() * sizeof(T));
+        }
+    }
+};
+
+// 从缓存区段依次读取，越界时ok()变为false，之后的读取都失败
+// 只保存指向data的指针，data须在读取期间保持有效
+class CacheReader {
+private:
+    const char* p;
+    const char* end;
+    bool good;
+
+public:
+    explicit CacheReader(const std::string& data)
+        : p(data.data()), end(data.data() + data.size()), good(true) {}
+
+    template <class T>
+    bool get(T& value) {
+        if (!good || (size_t)(end - p) < sizeof(T)) return good = false;
+        memcpy(&value, p, sizeof(T));
+        p += sizeof(T);
+        return true;
+    }
+
+    template <class T>
+    bool getArray(std::vector<T>& values) {
+        uint64_t n;
+        if (!get(n) || n > (uint64_t)(end - p) / sizeof(T)) return good = false;
+        values.resize((size_t)n);
+        if (n > 0) memcpy(values.data(), p, (size_t)n * sizeof(T));
+        p += (size_t)n * sizeof(T);
+        return true;
+    }
+
+    bool ok() const {
+        return good;
+    }
+
+    // 是否恰好读完
+    bool atEnd() const {
+        return good && p == end;
+    }
+};
+
+// 各程序默认使用的缓存文件：环境变量GRAMMAR_CACHE指定的路径（设为空串时不使用缓存），
+// 未设置时为可执行文件旁边的"<程序名>.gcache"；取不到可执行文件路径时返回空串
+inline std::string defaultCachePath() {
+    const char* env = getenv("GRAMMAR_CACHE");
+    if (env != nullptr) return env;
+    char exe[4096];
+    ssize_t n = readlink("/proc/self/exe", exe, sizeof(exe) - 1);
+    if (n <= 0) return "";
+    return std::string(exe, (size_t)n) + ".gcache";
+}
+
+class AnalysisCache {
+private:
+    static const uint32_t VERSION = 2;
+
+    uint64_t key;                                   // 文法散列
+    uint32_t revision;                              // 分析器修订号
+    std::map<std::string, std::string> sections;    // 区段名 -> 数据
+
+public:
+    AnalysisCache() : key(0), revision(analysisRevision) {}
+
+    // 读取缓存文件；文件不存在、损坏或文法散列、分析器修订号不符时返回false，
+    // 缓存为空、键为grammarHash和analyzerRevision（只有测试需要指定修订号）
+    bool load(const std::string& path, uint64_t grammarHash,
+              uint32_t analyzerRevision = analysisRevision) {
+        key = grammarHash;
+        revision = analyzerRevision;
+        sections.clear();
+
+        std::ifstream in(path.c_str(), std::ios::binary);
+        if (!in) return false;
+        std::stringstream ss;
+        ss << in.rdbuf();
+        std::string content = ss.str();
+        if (content.size() < 4 || content.compare(0, 4, "GAC1") != 0) return false;
+        content.erase(0, 4);
+
+        CacheReader reader(content);
+        uint32_t version, fileRevision, count;
+        uint64_t fileKey;
+        if (!reader.get(version) || version != VERSION) return false;
+        if (!reader.get(fileRevision) || fileRevision != revision) return false;
+        if (!reader.get(fileKey) || fileKey != grammarHash) return false;
+        if (!reader.get(count)) return false;
+        std::map<std::string, std::string> loaded;
+        for (uint32_t i = 0; i < count; i++) {
+            std::vector<char> name, data;
+            if (!reader.getArray(name) || !reader.getArray(data)) return false;
+            loaded[std::string(name.begin(), name.end())] = std::string(data.begin(), data.end());
+        }
+        if (!reader.atEnd()) return false;
+        sections.swap(loaded);
+        return true;
+    }
+
+    // 取得区段数据，不存在时返回false
+    bool get(const std::string& name, std::string& data) const {
+        std::map<std::string, std::string>::const_iterator it = sections.find(name);
+        if (it == sections.end()) return false;
+        data = it->second;
+        return true;
+    }
+
+    void put(const std::string& name, const std::string& data) {
+        sections[name] = data;
+    }
+
+    // 写回缓存文件：先写临时文件再改名，并发启动的进程不会读到写了一半的文件
+    bool save(const std::string& path) const {
+        CacheWriter writer;
+        writer.put(VERSION);
+        writer.put(revision);
+        writer.put(key);
+        writer.put((uint32_t)sections.size());
+        for (std::map<std::string, std::string>::const_iterator it = sections.begin();
+             it != sections.end(); ++it) {
+            writer.putArray(std::vector<char>(it->first.begin(), it->first.end()));
+            writer.putArray(std::vector<char>(it->second.begin(), it->second.end()));
+        }
+
+        std::string temp = path + "." + std::to_string((long)getpid()) + ".tmp";
+        {
+            std::ofstream out(temp.c_str(), std::ios::binary);
+            out.write("GAC1", 4);
+            out.write(writer.data.data(), writer.data.size());
+            if (!out) {
+                remove(temp.c_str());
+                return false;
+            }
+        }
+        return rename(temp.c_str(), path.c_str()) == 0;
+    }
+};
+
+#endif
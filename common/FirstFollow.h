@@ -0,0 +1,279 @@
+// ============================================================
+// FIRST/FOLLOW集计算引擎
+// 功能：对编号化的文法计算nullable、FIRST集和FOLLOW集
+// 使用者：实验二LLparser.h的Grammar、实验三LRparser.h的LRParser、
+//         实验三first_follow_tool
+// 约定：
+//   1. 符号编号0 ~ terminalCount-1为终结符，其后为非终结符
+//   2. 空串不是符号：空产生式的产生式体长度为0，可空性单独记录
+//   3. FIRST/FOLLOW集是以终结符编号为下标的位集
+// 算法：按符号之间的依赖关系建立传播边，用工作表只重新处理集合发生变化的符号，
+//       每条边上的一次传播是一次按字（64个终结符）的位或
+// ============================================================
+#ifndef FIRST_FOLLOW_H
+#define FIRST_FOLLOW_H
+
+#include <cstdint>
+#include <vector>
+
+// ============================================================
+// TerminalSet类：终结符集合
+// 以终结符编号为下标的位集，大小在构造时确定
+// ============================================================
+class TerminalSet {
+private:
+    std::vector<uint64_t> words;
+
+    friend class FirstFollowEngine;
+
+public:
+    TerminalSet() {}
+    explicit TerminalSet(int terminalCount) : words((terminalCount + 63) / 64, 0) {}
+
+    void insert(int t) {
+        words[t >> 6] |= 1ULL << (t & 63);
+    }
+
+    bool contains(int t) const {
+        return (words[t >> 6] >> (t & 63)) & 1;
+    }
+
+    bool empty() const {
+        for (uint64_t w : words) {
+            if (w != 0) return false;
+        }
+        return true;
+    }
+
+    void clear() {
+        for (uint64_t& w : words) w = 0;
+    }
+
+    // 并入另一个集合，返回是否加入了新元素
+    bool unite(const TerminalSet& other) {
+        uint64_t added = 0;
+        for (size_t i = 0; i < words.size(); i++) {
+            uint64_t w = words[i] | other.words[i];
+            added |= w ^ words[i];
+            words[i] = w;
+        }
+        return added != 0;
+    }
+
+    // 按编号从小到大访问每个元素
+    template <class Visitor>
+    void forEach(Visitor visit) const {
+        for (size_t i = 0; i < words.size(); i++) {
+            uint64_t w = words[i];
+            while (w != 0) {
+                visit((int)(i * 64 + __builtin_ctzll(w)));
+                w &= w - 1;
+            }
+        }
+    }
+};
+
+// ============================================================
+// FirstFollowEngine类：FIRST/FOLLOW集计算引擎
+// 用法：构造 -> addProduction()/addFollow() -> compute() -> 查询
+//       或者：构造 -> restoreState() -> 查询（结果来自分析缓存）
+// ============================================================
+class FirstFollowEngine {
+private:
+    int terminalCount;
+    int symbolCount;
+
+    // 产生式：左部和在bodies中的区间
+    std::vector<int> lhs;
+    std::vector<int> begin;
+    std::vector<int> length;
+    std::vector<int> bodies;
+
+    std::vector<char> nullable;                 // 符号 -> 是否可推导出空串
+    std::vector<TerminalSet> firstSets;         // 符号 -> FIRST集（不含空串）
+    std::vector<TerminalSet> followSets;        // 符号 -> FOLLOW集
+
+    bool isTerminal(int symbol) const {
+        return symbol < terminalCount;
+    }
+
+    // 沿传播边X -> Y把sets[X]并入sets[Y]，直到不再变化；edges[X]为以X为起点的边的终点
+    void propagate(std::vector<TerminalSet>& sets, const std::vector<std::vector<int>>& edges) {
+        std::vector<int> work;
+        std::vector<char> queued(symbolCount, 0);
+        for (int x = terminalCount; x < symbolCount; x++) {
+            if (!edges[x].empty() && !sets[x].empty()) {
+                work.push_back(x);
+                queued[x] = 1;
+            }
+        }
+        while (!work.empty()) {
+            int x = work.back();
+            work.pop_back();
+            queued[x] = 0;
+            for (int y : edges[x]) {
+                if (sets[y].unite(sets[x]) && !queued[y] && !edges[y].empty()) {
+                    work.push_back(y);
+                    queued[y] = 1;
+                }
+            }
+        }
+    }
+
+    // 计算可空性：记录每个产生式还有几个符号未确定为可空，
+    // 某个非终结符变为可空时只更新含有它的产生式
+    void computeNullable() {
+        std::vector<int> remaining(length);
+        std::vector<std::vector<int>> occurrences(symbolCount);
+        std::vector<int> work;
+        for (size_t p = 0; p < lhs.size(); p++) {
+            for (int k = 0; k < length[p]; k++) {
+                occurrences[bodies[begin[p] + k]].push_back((int)p);
+            }
+            if (length[p] == 0 && !nullable[lhs[p]]) {
+                nullable[lhs[p]] = 1;
+                work.push_back(lhs[p]);
+            }
+        }
+        while (!work.empty()) {
+            int x = work.back();
+            work.pop_back();
+            for (int p : occurrences[x]) {
+                if (--remaining[p] == 0 && !nullable[lhs[p]]) {
+                    nullable[lhs[p]] = 1;
+                    work.push_back(lhs[p]);
+                }
+            }
+        }
+    }
+
+    // 计算FIRST集：对A -> X1 X2 ... Xn，在X1...Xi-1都可空时FIRST(Xi) ⊆ FIRST(A)
+    void computeFirst() {
+        std::vector<std::vector<int>> edges(symbolCount);
+        for (int t = 0; t < terminalCount; t++) {
+            firstSets[t].insert(t);
+        }
+        for (size_t p = 0; p < lhs.size(); p++) {
+            for (int k = 0; k < length[p]; k++) {
+                int x = bodies[begin[p] + k];
+                if (isTerminal(x)) {
+                    firstSets[lhs[p]].insert(x);
+                    break;
+                }
+                if (x != lhs[p]) edges[x].push_back(lhs[p]);
+                if (!nullable[x]) break;
+            }
+        }
+        propagate(firstSets, edges);
+    }
+
+    // 计算FOLLOW集：对A -> αBβ，FIRST(β) ⊆ FOLLOW(B)；β可空时FOLLOW(A) ⊆ FOLLOW(B)
+    // 从产生式末尾向前扫描，FIRST(β)随扫描逐步累积
+    void computeFollow() {
+        std::vector<std::vector<int>> edges(symbolCount);
+        TerminalSet suffixFirst(terminalCount);
+        for (size_t p = 0; p < lhs.size(); p++) {
+            suffixFirst.clear();
+            bool suffixNullable = true;
+            for (int k = length[p] - 1; k >= 0; k--) {
+                int x = bodies[begin[p] + k];
+                if (!isTerminal(x)) {
+                    followSets[x].unite(suffixFirst);
+                    if (suffixNullable && x != lhs[p]) edges[lhs[p]].push_back(x);
+                }
+                if (!nullable[x]) {
+                    suffixFirst.clear();
+                    suffixNullable = false;
+                }
+                suffixFirst.unite(firstSets[x]);
+            }
+        }
+        propagate(followSets, edges);
+    }
+
+public:
+    // 参数：终结符个数和非终结符个数
+    FirstFollowEngine(int terminals = 0, int nonTerminals = 0)
+        : terminalCount(terminals), symbolCount(terminals + nonTerminals),
+          nullable(symbolCount, 0),
+          firstSets(symbolCount, TerminalSet(terminals)),
+          followSets(symbolCount, TerminalSet(terminals)) {}
+
+    // 添加产生式lhs -> body[0] ... body[n-1]，空产生式n为0
+    void addProduction(int left, const int* body, int n) {
+        lhs.push_back(left);
+        begin.push_back((int)bodies.size());
+        length.push_back(n);
+        bodies.insert(bodies.end(), body, body + n);
+    }
+
+    void addProduction(int left, const std::vector<int>& body) {
+        addProduction(left, body.data(), (int)body.size());
+    }
+
+    // 预先把终结符加入某个非终结符的FOLLOW集（如起始符号的$）
+    void addFollow(int nonTerminal, int terminal) {
+        followSets[nonTerminal].insert(terminal);
+    }
+
+    // 依次计算可空性、FIRST集和FOLLOW集
+    void compute() {
+        computeNullable();
+        computeFirst();
+        computeFollow();
+    }
+
+    bool isNullable(int symbol) const {
+        return nullable[symbol] != 0;
+    }
+
+    // FIRST集，不含空串；空串是否属于FIRST集由isNullable()给出
+    const TerminalSet& first(int symbol) const {
+        return firstSets[symbol];
+    }
+
+    const TerminalSet& follow(int symbol) const {
+        return followSets[symbol];
+    }
+
+    // 导出计算结果：每个符号依次为可空性（一个字）、FIRST集、FOLLOW集的各个字
+    // 供分析缓存保存，下次由restoreState()恢复而不必重新计算
+    std::vector<uint64_t> saveState() const {
+        std::vector<uint64_t> state;
+        for (int x = 0; x < symbolCount; x++) {
+            state.push_back(nullable[x]);
+            state.insert(state.end(), firstSets[x].words.begin(), firstSets[x].words.end());
+            state.insert(state.end(), followSets[x].words.begin(), followSets[x].words.end());
+        }
+        return state;
+    }
+
+    // 恢复saveState()导出的结果，代替compute()；长度与本引擎的符号个数不符时返回false
+    bool restoreState(const std::vector<uint64_t>& state) {
+        return restoreState(state.data(), state.size());
+    }
+
+    // 同上，直接读取数组（如编译进程序的静态数组），不必先复制到vector
+    bool restoreState(const uint64_t* state, size_t n) {
+        size_t wordCount = (size_t)(terminalCount + 63) / 64;
+        if (n != (size_t)symbolCount * (1 + 2 * wordCount)) return false;
+        size_t pos = 0;
+        for (int x = 0; x < symbolCount; x++) {
+            nullable[x] = state[pos++] != 0;
+            for (size_t i = 0; i < wordCount; i++) firstSets[x].words[i] = state[pos++];
+            for (size_t i = 0; i < wordCount; i++) followSets[x].words[i] = state[pos++];
+        }
+        return true;
+    }
+
+    // 把符号串的FIRST集（不含空串）并入out，返回符号串是否可空
+    bool firstOfSequence(const int* symbols, int n, TerminalSet& out) const {
+        for (int k = 0; k < n; k++) {
+            out.unite(firstSets[symbols[k]]);
+            if (!nullable[symbols[k]]) return false;
+        }
+        return true;
+    }
+};
+
+#endif
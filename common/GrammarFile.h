@@ -0,0 +1,195 @@
+// ============================================================
+// 文法文件
+// 功能：读取BNF格式的文法文本（格式见c_subset.bnf的文件头），
+//       按规则顺序给出各非终结符的候选式，并计算文法内容的散列值
+// 使用者：实验二LLparser.h的Grammar、实验三LRparser.h的LRParser、
+//         实验三first_follow_tool和table_visualizer
+// 约定：
+//   1. 候选式是符号名的序列，空串候选式为{"E"}，与原来硬编码的写法一致
+//   2. 同一左部分散在多条规则中时，候选式按出现顺序合并到第一条规则
+//   3. 散列值只由规则内容决定，修改注释和空白不会使分析缓存失效
+// ============================================================
+#ifndef GRAMMAR_FILE_H
+#define GRAMMAR_FILE_H
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// 一个非终结符的全部候选式
+struct GrammarRule {
+    std::string lhs;                                // 左部
+    std::vector<std::vector<std::string>> alternatives;  // 候选式，按定义顺序
+};
+
+class GrammarFile {
+private:
+    std::map<std::string, size_t> ruleIndex;        // 左部 -> rules中的下标
+
+    // 把一行按空白切分为符号
+    static std::vector<std::string> splitSymbols(const std::string& line) {
+        std::vector<std::string> symbols;
+        std::istringstream in(line);
+        std::string symbol;
+        while (in >> symbol) {
+            symbols.push_back(symbol);
+        }
+        return symbols;
+    }
+
+    bool fail(int line, const std::string& message) {
+        error = "第" + std::to_string(line) + "行: " + message;
+        rules.clear();
+        ruleIndex.clear();
+        return false;
+    }
+
+    // 把symbols[from..]按|切分为候选式，追加到第rule条规则
+    bool addAlternatives(size_t rule, const std::vector<std::string>& symbols, size_t from, int line) {
+        std::vector<std::string> alternative;
+        for (size_t i = from; i <= symbols.size(); i++) {
+            if (i < symbols.size() && symbols[i] != "|") {
+                if (symbols[i] == "->") return fail(line, "候选式中出现\"->\"");
+                alternative.push_back(symbols[i]);
+                continue;
+            }
+            if (alternative.empty()) return fail(line, "空的候选式（空串请写作E）");
+            for (size_t k = 0; k < alternative.size(); k++) {
+                if (alternative[k] == "E" && alternative.size() > 1) {
+                    return fail(line, "E只能单独构成一个候选式");
+                }
+            }
+            rules[rule].alternatives.push_back(alternative);
+            alternative.clear();
+        }
+        return true;
+    }
+
+    // 对规范化的规则文本（每条规则一行，符号间一个空格）计算FNV-1a散列
+    void computeHash() {
+        std::string canonical;
+        for (size_t r = 0; r < rules.size(); r++) {
+            canonical += rules[r].lhs + " ->";
+            for (size_t a = 0; a < rules[r].alternatives.size(); a++) {
+                if (a > 0) canonical += " |";
+                for (size_t k = 0; k < rules[r].alternatives[a].size(); k++) {
+                    canonical += " " + rules[r].alternatives[a][k];
+                }
+            }
+            canonical += "\n";
+        }
+        hash = 14695981039346656037ULL;
+        for (size_t i = 0; i < canonical.size(); i++) {
+            hash ^= (unsigned char)canonical[i];
+            hash *= 1099511628211ULL;
+        }
+    }
+
+public:
+    std::vector<GrammarRule> rules;     // 按左部第一次出现的顺序，第一条的左部是起始符号
+    uint64_t hash;                      // 规则内容的FNV-1a散列值，用作分析缓存的键
+    std::string error;                  // parse()/load()失败的原因
+
+    GrammarFile() : hash(0) {}
+
+    // 解析文法文本，失败时返回false并设置error
+    bool parse(const std::string& text) {
+        rules.clear();
+        ruleIndex.clear();
+        error.clear();
+
+        std::istringstream in(text);
+        std::string line;
+        int lineNo = 0;
+        size_t current = 0;             // 续行所属的规则
+        bool hasCurrent = false;
+        while (std::getline(in, line)) {
+            lineNo++;
+            size_t comment = line.find('#');
+            if (comment != std::string::npos) line.erase(comment);
+            std::vector<std::string> symbols = splitSymbols(line);
+            if (symbols.empty()) continue;
+            // 使文件可以被#include的首尾两行
+            if (symbols.size() == 1 && (symbols[0] == "R\"BNF(" || symbols[0] == ")BNF\"")) continue;
+
+            if (symbols[0] == "|") {
+                if (!hasCurrent) return fail(lineNo, "续行之前没有规则");
+                if (!addAlternatives(current, symbols, 1, lineNo)) return false;
+                continue;
+            }
+            if (symbols.size() < 2 || symbols[1] != "->") return fail(lineNo, "缺少\"->\"");
+            const std::string& lhs = symbols[0];
+            if (lhs == "E" || lhs == "|" || lhs == "->") return fail(lineNo, "非法的左部\"" + lhs + "\"");
+
+            std::map<std::string, size_t>::iterator it = ruleIndex.find(lhs);
+            if (it == ruleIndex.end()) {
+                GrammarRule rule;
+                rule.lhs = lhs;
+                it = ruleIndex.insert(std::make_pair(lhs, rules.size())).first;
+                rules.push_back(rule);
+            }
+            current = it->second;
+            hasCurrent = true;
+            if (!addAlternatives(current, symbols, 2, lineNo)) return false;
+        }
+        if (rules.empty()) return fail(lineNo, "文法中没有规则");
+
+        computeHash();
+        return true;
+    }
+
+    // 从文件读取并解析文法
+    bool load(const std::string& path) {
+        std::ifstream in(path.c_str(), std::ios::binary);
+        if (!in) {
+            error = "无法读取文法文件: " + path;
+            return false;
+        }
+        std::stringstream ss;
+        ss << in.rdbuf();
+        return parse(ss.str());
+    }
+
+    const std::string& startSymbol() const {
+        return rules[0].lhs;
+    }
+
+    bool isNonTerminal(const std::string& symbol) const {
+        return ruleIndex.count(symbol) != 0;
+    }
+
+    // 所有终结符（不含E），按第一次出现的顺序
+    std::vector<std::string> terminals() const {
+        std::vector<std::string> result;
+        std::set<std::string> seen;
+        for (size_t r = 0; r < rules.size(); r++) {
+            for (size_t a = 0; a < rules[r].alternatives.size(); a++) {
+                const std::vector<std::string>& alternative = rules[r].alternatives[a];
+                for (size_t k = 0; k < alternative.size(); k++) {
+                    const std::string& s = alternative[k];
+                    if (s != "E" && !isNonTerminal(s) && seen.insert(s).second) {
+                        result.push_back(s);
+                    }
+                }
+            }
+        }
+        return result;
+    }
+};
+
+// 实验二、实验三共用的C语言子集文法，编译时从c_subset.bnf嵌入
+inline const GrammarFile& cSubsetGrammar() {
+    static const char* const text =
+#include "c_subset.bnf"
+        ;
+    static GrammarFile grammar;
+    static bool parsed = grammar.parse(text);
+    (void)parsed;
+    return grammar;
+}
+
+#endif
@@ -0,0 +1,51 @@
+// 由rd_generator --tables根据common/c_subset.bnf生成的LL(1)分析结果，请勿手工修改
+// 重新生成：cd lab_2/rd_generator && make tables
+// LLParser的文法散列与C_SUBSET_LL1_HASH相同时直接使用这些数组，不同时忽略本文件
+#ifndef C_SUBSET_LL1_H
+#define C_SUBSET_LL1_H
+
+#include <cstdint>
+
+static const uint64_t C_SUBSET_LL1_HASH = 0xf2df919bcb8cfb62ULL;
+
+// 每个符号依次为：可空标记、FIRST集的位、FOLLOW集的位
+static const uint64_t C_SUBSET_LL1_STATE[108] = {
+    0x0ULL, 0x1ULL, 0x0ULL, 0x0ULL, 0x2ULL, 0x0ULL,
+    0x0ULL, 0x4ULL, 0x0ULL, 0x0ULL, 0x8ULL, 0x0ULL,
+    0x0ULL, 0x10ULL, 0x0ULL, 0x0ULL, 0x20ULL, 0x0ULL,
+    0x0ULL, 0x40ULL, 0x0ULL, 0x0ULL, 0x80ULL, 0x0ULL,
+    0x0ULL, 0x100ULL, 0x0ULL, 0x0ULL, 0x200ULL, 0x0ULL,
+    0x0ULL, 0x400ULL, 0x0ULL, 0x0ULL, 0x800ULL, 0x0ULL,
+    0x0ULL, 0x1000ULL, 0x0ULL, 0x0ULL, 0x2000ULL, 0x0ULL,
+    0x0ULL, 0x4000ULL, 0x0ULL, 0x0ULL, 0x8000ULL, 0x0ULL,
+    0x0ULL, 0x10000ULL, 0x0ULL, 0x0ULL, 0x20000ULL, 0x0ULL,
+    0x0ULL, 0x40000ULL, 0x0ULL, 0x0ULL, 0x80000ULL, 0x0ULL,
+    0x0ULL, 0x100000ULL, 0x0ULL, 0x0ULL, 0x200000ULL, 0x0ULL,
+    0x0ULL, 0x180004ULL, 0x7d8ULL, 0x1ULL, 0x1800ULL, 0x7d8ULL,
+    0x0ULL, 0x80000ULL, 0xe8003ULL, 0x0ULL, 0x180004ULL, 0x8ULL,
+    0x0ULL, 0x7c0ULL, 0x180004ULL, 0x0ULL, 0x1ULL, 0x2e8003ULL,
+    0x0ULL, 0x8000ULL, 0xe8003ULL, 0x0ULL, 0x180004ULL, 0x1fd8ULL,
+    0x1ULL, 0x6000ULL, 0x1fd8ULL, 0x0ULL, 0x1ULL, 0x200000ULL,
+    0x0ULL, 0x180004ULL, 0x7fd8ULL, 0x0ULL, 0xc8001ULL, 0xe8003ULL,
+    0x1ULL, 0xc8001ULL, 0x2ULL, 0x0ULL, 0x40000ULL, 0xe8003ULL,
+};
+
+// 分析表：每行一个非终结符，每列一个终结符（TokenKind顺序），-1表示无对应表项
+static const int16_t C_SUBSET_LL1_TABLE[308] = {
+    -1, -1, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 0, -1,  // arithexpr
+    -1, -1, -1, 3, 3, -1, 3, 3, 3, 3, 3, 1, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // arithexprprime
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 4, -1, -1,  // assgstmt
+    -1, -1, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 5, 5, -1,  // boolexpr
+    -1, -1, -1, -1, -1, -1, 6, 7, 8, 9, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // boolop
+    11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // compoundstmt
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 12, -1, -1, -1, -1, -1, -1,  // ifstmt
+    -1, -1, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 13, 13, -1,  // multexpr
+    -1, -1, -1, 16, 16, -1, 16, 16, 16, 16, 16, 16, 16, 14, 15, -1, -1, -1, -1, -1, -1, -1,  // multexprprime
+    17, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // program
+    -1, -1, 20, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 18, 19, -1,  // simpleexpr
+    24, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 21, -1, -1, 22, 23, -1, -1,  // stmt
+    25, 26, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 25, -1, -1, 25, 25, -1, -1,  // stmts
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 27, -1, -1, -1,  // whilestmt
+};
+
+#endif
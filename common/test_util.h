@@ -0,0 +1,72 @@
+// ============================================================
+// 测试辅助函数
+// 功能：各实验的测试程序共用的通过/失败计数、结果汇总、文件读写，
+//       以及捕获分析器写到cout的错误信息和语法树
+// 使用者：各功能目录下的*_test.cpp测试程序
+// 约定：测试程序逐项调用check()，main()最后返回testSummary()
+// ============================================================
+#ifndef TEST_UTIL_H
+#define TEST_UTIL_H
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// 通过和失败的检查数
+struct TestCounts {
+    int passed;
+    int failed;
+};
+
+inline TestCounts& testCounts() {
+    static TestCounts counts = {0, 0};
+    return counts;
+}
+
+/* 记录一项检查的结果并输出 */
+inline void check(bool condition, const std::string& name) {
+    if (condition) {
+        testCounts().passed++;
+        std::cout << "✓ " << name << std::endl;
+    } else {
+        testCounts().failed++;
+        std::cout << "✗ " << name << std::endl;
+    }
+}
+
+/* 输出通过和失败的数目，返回main()的退出码 */
+inline int testSummary() {
+    std::cout << "\n通过: " << testCounts().passed << ", 失败: " << testCounts().failed << std::endl;
+    return testCounts().failed == 0 ? 0 : 1;
+}
+
+inline std::string readFile(const std::string& path) {
+    std::ifstream in(path.c_str(), std::ios::binary);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+inline void writeFile(const std::string& path, const std::string& content) {
+    std::ofstream out(path.c_str(), std::ios::binary);
+    out << content;
+}
+
+/* 执行action，返回执行期间写到cout的内容 */
+template <class Action>
+std::string captureOutput(Action action) {
+    std::stringstream captured;
+    std::streambuf* old = std::cout.rdbuf(captured.rdbuf());
+    action();
+    std::cout.rdbuf(old);
+    return captured.str();
+}
+
+/* 分析程序，返回输出的错误信息和语法树（parse()先输出错误信息，再由print()输出语法树） */
+template <class Parser>
+std::string parseAndPrint(Parser& parser, const std::string& prog) {
+    return captureOutput([&] { parser.parse(prog).print(); });
+}
+
+#endif
@@ -0,0 +1,777 @@
+// 按语言配置实例化的词法分析器
+// 实验一的LexAnalysis.h使用完整C语言的LexicalAnalyzer；实验二、三的语法分析器使用
+// SubsetLexicalAnalyzer，把Token编号转换为各自的终结符，不再各自维护一份词法分析。
+// 放在命名空间lex中，与语法分析器各自的Token类不冲突；LexAnalysis.h把这些名字引入全局。
+#ifndef BASIC_LEXICAL_ANALYZER_H
+#define BASIC_LEXICAL_ANALYZER_H
+
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include "Utf8Identifier.h"
+#include "LanguageProfile.h"
+#include "LexHash.h"
+
+/* 定义在IdentifierIndex.h中，只有调用setIndex()的程序需要包含 */
+class IdentifierIndexBuilder;
+
+namespace lex {
+
+using namespace std;
+
+/* 词法单元类，用于表示识别出的Token */
+class Token {
+public:
+	string name;      // 符号名称
+	int code;         // 符号编号
+	size_t offset;    // 在源程序中的起始字节偏移
+	int line;         // 起始行号
+
+	Token(const string& n, int c, size_t off = 0, int l = 1)
+		: name(n), code(c), offset(off), line(l) {}
+
+	Token(const char* text, size_t len, int c, size_t off, int l)
+		: name(text, len), code(c), offset(off), line(l) {}
+};
+
+/* 不带名称的Token：符号名称就是源程序中的[begin, end)，由nextSpan()给出 */
+struct TokenSpan {
+	size_t begin;     // 起始字节偏移
+	size_t end;       // 结束字节偏移（不含）
+	int code;         // 符号编号
+	int line;         // 起始行号
+};
+
+/* 词法规则修订号：修改扫描规则或Token编号时加1，使各分支、各CI作业共享的缓存结果失效 */
+static const uint32_t lexerRevision = 1;
+
+/* 词法分析器类，基于有限自动机（DFA）设计
+   Profile为语言配置（见LanguageProfile.h），未启用的特性和符号在编译期裁剪掉 */
+template <class Profile>
+class BasicLexicalAnalyzer {
+private:
+	string ownedInput;     // 由string构造时持有的源程序副本，推送模式下为尚未处理完的输入
+	const char* input;     // 输入的源程序（可直接指向调用方的缓冲区）
+	size_t length;         // 输入长度
+	size_t pos;            // 当前读取位置
+	int line;              // 当前行号
+	vector<Token> tokens;  // 识别出的所有Token
+	size_t nextIndex;      // 增量模式下下一个待取出的Token
+	size_t base;           // 推送模式下ownedInput[0]在整个输入流中的偏移
+	size_t pendingNeed;    // 推送模式下未完成部分至少积累到多少字节才重新扫描
+	IdentifierIndexBuilder* index;     // 可选的标识符索引
+	void (*indexAdd)(IdentifierIndexBuilder*, const string&, uint32_t, uint64_t);  // 由setIndex()设置
+	uint32_t indexFile;                // 当前源程序在索引中的文件编号
+	vector<size_t> pendingIdentifiers; // 已识别但尚未写入索引的标识符在tokens中的下标
+	size_t tokenStart;     // 正在识别的Token的起始位置
+	int tokenLine;         // 正在识别的Token的起始行号
+
+	/* 关键字首字符表：has[c]表示有关键字以c开头，由配置的关键字表生成 */
+	struct KeywordStarts {
+		bool has[256];
+		KeywordStarts() : has() {
+			const ProfileKeyword* list = Profile::keywords();
+			for (int i = 0; i < Profile::keywordCount; i++) {
+				has[(unsigned char)list[i].word[0]] = true;
+			}
+		}
+	};
+
+	/* 查找关键字，返回其编号，不是关键字时返回标识符的编号81
+	   关键字表是配置中的短数组，不必为每个标识符构造字符串、查map；
+	   首字符不是任何关键字的首字符时（大多数标识符）查一次首字符表就排除 */
+	static int keywordCode(const char* word, size_t len) {
+		static const KeywordStarts starts;
+		if (!starts.has[(unsigned char)word[0]]) return 81;
+		const ProfileKeyword* list = Profile::keywords();
+		for (int i = 0; i < Profile::keywordCount; i++) {
+			// 首字符不同时直接排除，否则逐字节比较；标识符中没有'\0'，关键字较短时在其结尾处停下
+			const char* k = list[i].word;
+			if (k[0] != word[0]) continue;
+			size_t j = 1;
+			while (j < len && k[j] == word[j]) {
+				j++;
+			}
+			if (j == len && k[len] == '\0') {
+				return list[i].code;
+			}
+		}
+		return 81;
+	}
+
+	/* 标识符的首字符：ASCII字母或下划线（与C locale下的isalpha相同，但不调用库函数） */
+	static bool identifierStart(unsigned char c) {
+		return (unsigned char)((c | 0x20) - 'a') < 26 || c == '_';
+	}
+
+	/* 十进制数字（与isdigit相同，但不调用库函数） */
+	static bool isDigit(char c) {
+		return (unsigned char)(c - '0') < 10;
+	}
+
+	/* 获取当前字符 */
+	char peek() {
+		if (pos >= length) return '\0';
+		return input[pos];
+	}
+
+	/* 消耗当前字符并前进 */
+	char advance() {
+		if (pos >= length) return '\0';
+		return input[pos++];
+	}
+
+	/* 向前看n个字符 */
+	char peekNext(size_t n = 1) {
+		if (pos + n >= length) return '\0';
+		return input[pos + n];
+	}
+
+	/* 跳过空白字符 */
+	void skipWhitespace() {
+		// 与C语言环境下的isspace相同：空格和\t\n\v\f\r，直接比较，不调用库函数
+		while (pos < length && (input[pos] == ' ' || (input[pos] >= '\t' && input[pos] <= '\r'))) {
+			if (input[pos] == '\n') line++;
+			pos++;
+		}
+	}
+
+	/* 尝试按UTF-8解码并消耗一个非ASCII标识符字符，isStart区分XID_Start与XID_Continue */
+	bool consumeUnicodeIdentifierChar(bool isStart) {
+		unsigned int cp = 0;
+		int len = decodeUtf8(input + pos, length - pos, cp);
+		if (len == 0) return false;
+		if (isStart ? !isXidStart(cp) : !isXidContinue(cp)) return false;
+		pos += len;
+		return true;
+	}
+
+	/* 识别标识符或关键字（自动机状态转换），支持UTF-8标识符；返回其编号，不是标识符时返回-1 */
+	int recognizeIdentifierOrKeyword() {
+		size_t start = pos;
+		// 状态0：开始状态，必须是字母、下划线或XID_Start字符
+		if (identifierStart(peek())) {
+			advance();
+		} else if (!Profile::unicodeIdentifiers || !consumeUnicodeIdentifierChar(true)) {
+			return -1;
+		}
+		// 状态1：接受状态，ASCII连续段走快速扫描，遇到非ASCII字节才解码
+		while (true) {
+			pos += asciiIdentifierRun(input + pos, length - pos);
+			if (!Profile::unicodeIdentifiers || (unsigned char)peek() < 0x80 ||
+			    !consumeUnicodeIdentifierChar(false)) {
+				break;
+			}
+		}
+		// 关键字或标识符
+		return keywordCode(input + start, pos - start);
+	}
+
+	/* 识别数字常量（自动机状态转换），返回其编号 */
+	int recognizeNumber() {
+		// 状态0：整数部分
+		while (isDigit(peek())) {
+			advance();
+		}
+
+		// 状态1：检查小数点
+		if (Profile::numberFractions && peek() == '.' && isDigit(peekNext())) {
+			advance();  // 消耗'.'
+			// 状态2：小数部分
+			while (isDigit(peek())) {
+				advance();
+			}
+		}
+
+		// 状态3：检查指数部分（科学计数法）
+		if (Profile::numberExponents && (peek() == 'e' || peek() == 'E')) {
+			char next = peekNext();
+			if (isDigit(next) || ((next == '+' || next == '-') && isDigit(peekNext(2)))) {
+				advance();  // 消耗'e'或'E'
+				if (peek() == '+' || peek() == '-') {
+					advance();
+				}
+				while (isDigit(peek())) {
+					advance();
+				}
+			}
+		}
+
+		// 检查后缀（如L、U、F等）
+		while (Profile::numberSuffixes &&
+		       (peek() == 'L' || peek() == 'l' ||
+		        peek() == 'U' || peek() == 'u' ||
+		        peek() == 'F' || peek() == 'f')) {
+			advance();
+		}
+
+		return 80;  // 常数编号为80
+	}
+
+	/* 识别运算符或界符（自动机状态转换），返回其编号，不是运算符或界符时返回-1
+	   按配置裁剪后分支很少，强制内联到scanCode()中，省去每个符号一次函数调用 */
+	__attribute__((always_inline)) int recognizeOperatorOrDelimiter() {
+		char c = peek();
+
+		// 按首字符分支（编译为跳转表），再按最长匹配原则识别多字符运算符
+		switch (c) {
+		case '-':
+			if (!Profile::hasSymbol(33)) break;
+			advance();
+			if (Profile::hasSymbol(34) && peek() == '-') {
+				advance();
+				return 34;
+			} else if (Profile::hasSymbol(35) && peek() == '=') {
+				advance();
+				return 35;
+			} else if (Profile::hasSymbol(36) && peek() == '>') {
+				advance();
+				return 36;
+			}
+			return 33;
+		case '!':
+			if (!Profile::hasSymbol(37)) break;
+			advance();
+			if (Profile::hasSymbol(38) && peek() == '=') {
+				advance();
+				return 38;
+			}
+			return 37;
+		case '%':
+			if (!Profile::hasSymbol(39)) break;
+			advance();
+			if (Profile::hasSymbol(40) && peek() == '=') {
+				advance();
+				return 40;
+			}
+			return 39;
+		case '&':
+			if (!Profile::hasSymbol(41)) break;
+			advance();
+			if (Profile::hasSymbol(42) && peek() == '&') {
+				advance();
+				return 42;
+			} else if (Profile::hasSymbol(43) && peek() == '=') {
+				advance();
+				return 43;
+			}
+			return 41;
+		case '*':
+			if (!Profile::hasSymbol(46)) break;
+			advance();
+			if (Profile::hasSymbol(47) && peek() == '=') {
+				advance();
+				return 47;
+			}
+			return 46;
+		case '/':
+			if (!Profile::hasSymbol(50)) break;
+			advance();
+			if (Profile::hasSymbol(51) && peek() == '=') {
+				advance();
+				return 51;
+			}
+			return 50;
+		case '^':
+			if (!Profile::hasSymbol(57)) break;
+			advance();
+			if (Profile::hasSymbol(58) && peek() == '=') {
+				advance();
+				return 58;
+			}
+			return 57;
+		case '|':
+			if (!Profile::hasSymbol(60)) break;
+			advance();
+			if (Profile::hasSymbol(61) && peek() == '|') {
+				advance();
+				return 61;
+			} else if (Profile::hasSymbol(62) && peek() == '=') {
+				advance();
+				return 62;
+			}
+			return 60;
+		case '+':
+			if (!Profile::hasSymbol(65)) break;
+			advance();
+			if (Profile::hasSymbol(66) && peek() == '+') {
+				advance();
+				return 66;
+			} else if (Profile::hasSymbol(67) && peek() == '=') {
+				advance();
+				return 67;
+			}
+			return 65;
+		case '<':
+			if (!Profile::hasSymbol(68)) break;
+			advance();
+			if (Profile::hasSymbol(69) && peek() == '<') {
+				advance();
+				if (Profile::hasSymbol(70) && peek() == '=') {
+					advance();
+					return 70;
+				}
+				return 69;
+			} else if (Profile::hasSymbol(71) && peek() == '=') {
+				advance();
+				return 71;
+			}
+			return 68;
+		case '=':
+			if (!Profile::hasSymbol(72)) break;
+			advance();
+			if (Profile::hasSymbol(73) && peek() == '=') {
+				advance();
+				return 73;
+			}
+			return 72;
+		case '>':
+			if (!Profile::hasSymbol(74)) break;
+			advance();
+			if (Profile::hasSymbol(76) && peek() == '>') {
+				advance();
+				if (Profile::hasSymbol(77) && peek() == '=') {
+					advance();
+					return 77;
+				}
+				return 76;
+			} else if (Profile::hasSymbol(75) && peek() == '=') {
+				advance();
+				return 75;
+			}
+			return 74;
+		// 单字符界符和运算符
+		case '(':
+			if (!Profile::hasSymbol(44)) break;
+			advance();
+			return 44;
+		case ')':
+			if (!Profile::hasSymbol(45)) break;
+			advance();
+			return 45;
+		case ',':
+			if (!Profile::hasSymbol(48)) break;
+			advance();
+			return 48;
+		case '.':
+			if (!Profile::hasSymbol(49)) break;
+			advance();
+			return 49;
+		case ':':
+			if (!Profile::hasSymbol(52)) break;
+			advance();
+			return 52;
+		case ';':
+			if (!Profile::hasSymbol(53)) break;
+			advance();
+			return 53;
+		case '?':
+			if (!Profile::hasSymbol(54)) break;
+			advance();
+			return 54;
+		case '[':
+			if (!Profile::hasSymbol(55)) break;
+			advance();
+			return 55;
+		case ']':
+			if (!Profile::hasSymbol(56)) break;
+			advance();
+			return 56;
+		case '{':
+			if (!Profile::hasSymbol(59)) break;
+			advance();
+			return 59;
+		case '}':
+			if (!Profile::hasSymbol(63)) break;
+			advance();
+			return 63;
+		case '~':
+			if (!Profile::hasSymbol(64)) break;
+			advance();
+			return 64;
+		}
+
+		return -1;
+	}
+
+	/* 处理注释（块注释和行注释两种形式），返回是否成功处理 */
+	bool handleComment() {
+		size_t start = pos;
+		int startLine = line;
+		if (Profile::blockComments && peek() == '/' && peekNext() == '*') {
+			// 块注释 /* */
+			string comment = "/*";
+			advance();  // 消耗'/'
+			advance();  // 消耗'*'
+
+			// 读取注释内容直到找到结束符*/
+			while (pos < length) {
+				if (peek() == '*' && peekNext() == '/') {
+					comment += '*';
+					advance();  // 消耗'*'
+					comment += '/';
+					advance();  // 消耗'/'
+					break;
+				}
+				if (peek() == '\n') line++;
+				comment += advance();
+			}
+
+			tokens.push_back(Token(comment, 79, start, startLine));
+			return true;
+		}
+		else if (Profile::lineComments && peek() == '/' && peekNext() == '/') {
+			// 行注释 //
+			string comment = "//";
+			advance();  // 消耗第一个'/'
+			advance();  // 消耗第二个'/'
+
+			// 读取到行尾
+			while (pos < length && peek() != '\n') {
+				comment += advance();
+			}
+
+			tokens.push_back(Token(comment, 79, start, startLine));
+			return true;
+		}
+
+		return false;
+	}
+
+	/* 处理字符串字面量 */
+	void handleString() {
+		if (peek() == '"') {
+			tokens.push_back(Token("\"", 78, pos, line));  // 开始引号
+			advance();  // 消耗开始引号
+
+			size_t start = pos;
+			int startLine = line;
+			string content;
+			// 读取字符串内容直到结束引号
+			while (pos < length && peek() != '"') {
+				if (peek() == '\\' && peekNext() != '\0') {
+					// 处理转义字符（反斜杠续行同样要计入行号）
+					if (peekNext() == '\n') line++;
+					content += advance();  // 添加'\'
+					content += advance();  // 添加转义字符
+				} else {
+					if (peek() == '\n') line++;
+					content += advance();
+				}
+			}
+
+			// 如果字符串内容不为空，将其作为标识符添加
+			if (!content.empty()) {
+				tokens.push_back(Token(content, 81, start, startLine));
+			}
+
+			// 添加结束引号
+			if (peek() == '"') {
+				tokens.push_back(Token("\"", 78, pos, line));
+				advance();
+			}
+		}
+	}
+
+	/* 把scanOne()记录的起始位置到当前位置的输入作为Token加入结果序列，返回true
+	   符号名称就是这段原文，直接在结果序列中构造，不经过临时字符串 */
+	bool emit(int code) {
+		// 字符串内容不经过这里，只有真正的标识符会进入索引
+		if (index != nullptr && code == 81) {
+			pendingIdentifiers.push_back(tokens.size());
+		}
+		tokens.emplace_back(input + tokenStart, pos - tokenStart, code, tokenStart, tokenLine);
+		return true;
+	}
+
+	/* 把已确定的标识符写入索引（推送模式下被撤销的Token不会写入） */
+	void flushIndex() {
+		for (size_t i = 0; i < pendingIdentifiers.size(); i++) {
+			const Token& t = tokens[pendingIdentifiers[i]];
+			indexAdd(index, t.name, indexFile, t.offset);
+		}
+		pendingIdentifiers.clear();
+	}
+
+	/* scanCode()没有得到编号时的返回值 */
+	enum {
+		NO_TOKEN = -1,       // 注释、字符串已直接加入tokens，或者跳过了未识别字符
+		END_OF_INPUT = -2    // 输入已处理完
+	};
+
+	/* 扫描一个词法单元，返回其编号，Token为[tokenStart, pos)的原文
+	   注释和字符串（字符串会产生多个Token）直接加入tokens */
+	int scanCode() {
+		skipWhitespace();
+
+		if (pos >= length) return END_OF_INPUT;
+
+		tokenStart = pos;
+		tokenLine = line;
+		char c = peek();
+
+		// 处理注释
+		if (c == '/' && ((Profile::blockComments && peekNext() == '*') ||
+		                 (Profile::lineComments && peekNext() == '/'))) {
+			if (handleComment()) {
+				return NO_TOKEN;
+			}
+		}
+
+		// 处理字符串
+		if (Profile::strings && c == '"') {
+			handleString();
+			return NO_TOKEN;
+		}
+
+		// 处理运算符和界符：最常见，先按首字符分支；与标识符、数字的首字符不重叠，顺序不影响结果
+		int code = recognizeOperatorOrDelimiter();
+		if (code >= 0) {
+			return code;
+		}
+
+		// 处理标识符或关键字（非ASCII字节尝试作为UTF-8标识符）
+		if (identifierStart(c) || (Profile::unicodeIdentifiers && (unsigned char)c >= 0x80)) {
+			code = recognizeIdentifierOrKeyword();
+			if (code >= 0) {
+				return code;
+			}
+		}
+
+		// 处理数字
+		if (isDigit(c)) {
+			return recognizeNumber();
+		}
+
+		// 未识别字符，跳过（鲁棒性处理）
+		advance();
+		return NO_TOKEN;
+	}
+
+	/* 扫描一个词法单元（字符串会产生多个Token），返回false表示输入已处理完 */
+	bool scanOne() {
+		int code = scanCode();
+		if (code >= 0) {
+			emit(code);
+		}
+		return code != END_OF_INPUT;
+	}
+
+	/* 主扫描函数 */
+	void scan() {
+		while (scanOne()) {
+			if (!pendingIdentifiers.empty()) flushIndex();
+		}
+	}
+
+	/* 推送模式：Token之后至少要有这么多字节，才能确定后续输入不会改变它
+	  （数字的指数部分向后看2个字节，UTF-8字符最长4个字节） */
+	static const size_t pushLookahead = 4;
+
+	/* 推送模式的扫描：final为false时，可能被后续输入改变的Token会被撤销，留到下次再扫描 */
+	void pushScan(bool final) {
+		while (true) {
+			size_t savedPos = pos;
+			int savedLine = line;
+			size_t savedCount = tokens.size();
+			bool more = scanOne();
+			if (!final && (!more || pos == length || length - pos < pushLookahead)) {
+				// 扫描到了缓冲区末尾（注释、字符串、标识符等尚未结束），或者向后看的字节不够：
+				// 撤销这一步。未结束的情况下等未完成部分翻倍再重试，保证总扫描量是线性的
+				size_t pending = length - savedPos;
+				pendingNeed = (!more || pos == length) ? 2 * pending
+				                                       : pending + pushLookahead - (length - pos);
+				pos = savedPos;
+				line = savedLine;
+				tokens.erase(tokens.begin() + savedCount, tokens.end());
+				pendingIdentifiers.clear();
+				return;
+			}
+			for (size_t i = savedCount; i < tokens.size(); i++) {
+				tokens[i].offset += base;
+			}
+			if (!pendingIdentifiers.empty()) flushIndex();
+			if (!more) return;
+		}
+	}
+
+public:
+	/* 构造函数：复制一份源程序 */
+	BasicLexicalAnalyzer(const string& source)
+		: ownedInput(source), input(ownedInput.data()), length(ownedInput.length()),
+		  pos(0), line(1), nextIndex(0), base(0), pendingNeed(0),
+		  index(nullptr), indexAdd(nullptr), indexFile(0) {}
+
+	/* 构造函数：直接在调用方的缓冲区上分析，缓冲区需在分析器销毁前保持有效 */
+	BasicLexicalAnalyzer(const char* source, size_t len)
+		: input(source), length(len), pos(0), line(1), nextIndex(0), base(0), pendingNeed(0),
+		  index(nullptr), indexAdd(nullptr), indexFile(0) {}
+
+	/* 构造函数：推送模式，输入通过feed()分段提供 */
+	BasicLexicalAnalyzer()
+		: input(ownedInput.data()), length(0), pos(0), line(1), nextIndex(0), base(0), pendingNeed(0),
+		  index(nullptr), indexAdd(nullptr), indexFile(0) {}
+
+	/* 分析器标识：由词法规则修订号和语言配置（可选特性、启用的符号、关键字表）计算，
+	   作为结果缓存的键的一部分，配置不同的分析器不会读到彼此的缓存 */
+	static uint64_t fingerprint() {
+		string id = "rev" + to_string(lexerRevision) + ";";
+		id += Profile::blockComments ? '1' : '0';
+		id += Profile::lineComments ? '1' : '0';
+		id += Profile::strings ? '1' : '0';
+		id += Profile::numberFractions ? '1' : '0';
+		id += Profile::numberExponents ? '1' : '0';
+		id += Profile::numberSuffixes ? '1' : '0';
+		id += Profile::unicodeIdentifiers ? '1' : '0';
+		id += ';';
+		for (int code = 0; code < 128; code++) {
+			id += Profile::hasSymbol(code) ? '1' : '0';
+		}
+		const ProfileKeyword* list = Profile::keywords();
+		for (int i = 0; i < Profile::keywordCount; i++) {
+			id += ";" + string(list[i].word) + "=" + to_string(list[i].code);
+		}
+		return lexHash128(id.data(), id.size()).lo;
+	}
+
+	/* 改为在调用方的缓冲区上从头分析，复用各数组的容量；之后用nextToken()或analyze()取得结果 */
+	void reset(const char* source, size_t len) {
+		ownedInput.clear();
+		input = source;
+		length = len;
+		pos = 0;
+		line = 1;
+		tokens.clear();
+		nextIndex = 0;
+		base = 0;
+		pendingNeed = 0;
+		pendingIdentifiers.clear();
+	}
+
+	/* input可能指向ownedInput，禁止拷贝 */
+	BasicLexicalAnalyzer(const BasicLexicalAnalyzer&) = delete;
+	BasicLexicalAnalyzer& operator=(const BasicLexicalAnalyzer&) = delete;
+
+	/* 增量模式：取出下一个Token，返回nullptr表示分析结束
+	   返回的指针在下一次调用前有效，已取出的Token不再保留 */
+	const Token* nextToken() {
+		while (nextIndex == tokens.size()) {
+			tokens.clear();
+			nextIndex = 0;
+			if (!scanOne()) return nullptr;
+			if (!pendingIdentifiers.empty()) flushIndex();
+		}
+		return &tokens[nextIndex++];
+	}
+
+	/* 增量模式的轻量版本：下一个Token放入span，返回false表示分析结束
+	   不构造Token和名称字符串，名称由调用方按偏移和长度从输入中取得；与nextToken()不能混用
+	   每个Token调用一次，强制内联到调用方的循环中 */
+	__attribute__((always_inline)) bool nextSpan(TokenSpan& span) {
+		// 没有注释和字符串的配置中tokens总是空的，编译期就去掉对它的检查
+		while (!(Profile::blockComments || Profile::lineComments || Profile::strings) ||
+		       nextIndex == tokens.size()) {
+			int code = scanCode();
+			if (code >= 0) {
+				span.begin = tokenStart;
+				span.end = pos;
+				span.code = code;
+				span.line = tokenLine;
+				if (index != nullptr && code == 81) {
+					indexAdd(index, string(input + tokenStart, pos - tokenStart), indexFile, tokenStart);
+				}
+				return true;
+			}
+			if (code == END_OF_INPUT) return false;
+		}
+		// 注释和字符串仍以Token的形式加入tokens（一次可能有多个），逐个转换，取完后清空
+		const Token& t = tokens[nextIndex++];
+		span.begin = t.offset;
+		span.end = t.offset + t.name.size();
+		span.code = t.code;
+		span.line = t.line;
+		if (nextIndex == tokens.size()) {
+			tokens.clear();
+			nextIndex = 0;
+		}
+		return true;
+	}
+
+	/* 分析时把标识符的出现位置记录到索引中，file为addFile()返回的文件编号
+	   Builder就是IdentifierIndexBuilder；写成模板使调用add()的代码只在调用本函数的程序中实例化，
+	   不建索引的程序（如实验二、三的语法分析器）不必包含IdentifierIndex.h */
+	template <class Builder>
+	void setIndex(Builder* builder, uint32_t file) {
+		index = builder;
+		indexFile = file;
+		indexAdd = [](IdentifierIndexBuilder* b, const string& name, uint32_t f, uint64_t offset) {
+			static_cast<Builder*>(b)->add(name, f, offset);
+		};
+	}
+
+	/* 推送模式：追加一段输入，返回这段输入使新完成的Token（偏移相对于整个输入流）
+	   跨段的标识符、注释、字符串、多字符运算符会保留到后续输入到达后再输出
+	   返回的引用在下一次feed()/finish()前有效；只能用于默认构造的分析器 */
+	const vector<Token>& feed(const char* data, size_t len) {
+		tokens.clear();
+		// 丢弃已处理的前缀，缓冲区中只保留未完成的部分
+		if (pos > 0) {
+			ownedInput.erase(0, pos);
+			base += pos;
+			pos = 0;
+		}
+		ownedInput.append(data, len);
+		input = ownedInput.data();
+		length = ownedInput.size();
+		if (length >= pendingNeed) {
+			pushScan(false);
+		}
+		return tokens;
+	}
+
+	const vector<Token>& feed(const string& chunk) {
+		return feed(chunk.data(), chunk.size());
+	}
+
+	/* 推送模式：输入结束，返回剩余的所有Token */
+	const vector<Token>& finish() {
+		tokens.clear();
+		pushScan(true);
+		return tokens;
+	}
+
+	/* 执行词法分析 */
+	void analyze() {
+		scan();
+	}
+
+	/* 获取识别出的所有Token */
+	const vector<Token>& getTokens() const {
+		return tokens;
+	}
+
+	/* 输出结果 */
+	void output() {
+		for (size_t i = 0; i < tokens.size(); i++) {
+			cout << (i + 1) << ": <" << tokens[i].name << "," << tokens[i].code << ">";
+			// 注意：最后一行后面不能有回车
+			if (i < tokens.size() - 1) {
+				cout << "\n";
+			}
+		}
+	}
+};
+
+/* 完整C语言的词法分析器 */
+typedef BasicLexicalAnalyzer<CProfile> LexicalAnalyzer;
+
+/* 实验二~四子集文法的词法分析器 */
+typedef BasicLexicalAnalyzer<SubsetProfile> SubsetLexicalAnalyzer;
+
+}
+
+#endif
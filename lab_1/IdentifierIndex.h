@@ -0,0 +1,450 @@
+// 标识符出现位置索引（倒排索引）
+// 词法分析时顺带记录每个标识符出现的(文件, 偏移)，同一标识符的出现位置按(文件, 偏移)递增排列，
+// 差分后用变长整数编码。索引文件按标识符排序、所有表都是定长记录，可以直接mmap后二分查找；
+// 分批建立的多个索引文件可以合并，合并时只需改写每个倒排表的第一个编码，其余字节原样复制。
+#ifndef IDENTIFIER_INDEX_H
+#define IDENTIFIER_INDEX_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* 一次出现 */
+struct IdentifierOccurrence {
+	uint32_t file;
+	uint64_t offset;
+};
+
+/* 索引文件头 */
+struct IdentifierIndexHeader {
+	char magic[4];          // "LXI1"
+	uint32_t version;       // 格式版本
+	uint32_t fileCount;     // 文件表项数
+	uint32_t symbolCount;   // 符号表项数
+	uint64_t fileTable;     // 各区段在文件中的偏移
+	uint64_t symbolTable;
+	uint64_t stringPool;
+	uint64_t postings;
+	uint64_t totalSize;     // 索引文件总长度，用于校验
+};
+
+/* 文件表项：文件名位于字符串池中 */
+struct IdentifierFileRecord {
+	uint64_t nameOffset;
+	uint32_t nameLength;
+	uint32_t reserved;
+};
+
+/* 符号表项，按名称排序；倒排表位于postings区 */
+struct IdentifierSymbolRecord {
+	uint64_t nameOffset;
+	uint32_t nameLength;
+	uint32_t count;         // 出现次数
+	uint64_t postingOffset;
+	uint64_t postingLength;
+	uint32_t lastFile;      // 最后一次出现所在的文件，合并时用于改写下一段的第一个差分
+	uint32_t reserved;
+};
+
+static const uint32_t identifierIndexVersion = 1;
+
+/* 变长整数编码：每字节7位，最高位表示后面还有字节 */
+inline void putVarint(std::string& out, uint64_t v) {
+	while (v >= 0x80) {
+		out += (char)(v | 0x80);
+		v >>= 7;
+	}
+	out += (char)v;
+}
+
+/* 变长整数解码，越界或超过10字节时返回false */
+inline bool getVarint(const unsigned char*& p, const unsigned char* end, uint64_t& v) {
+	v = 0;
+	for (int shift = 0; shift < 70 && p < end; shift += 7) {
+		unsigned char b = *p++;
+		v |= (uint64_t)(b & 0x7f) << shift;
+		if (!(b & 0x80)) return true;
+	}
+	return false;
+}
+
+/* 倒排表的编码：每次出现依次编码文件差分，以及同一文件内的偏移差分（换文件时为绝对偏移），
+   初始的“上一次出现”为(0, 0) */
+inline void encodeOccurrence(std::string& out, uint32_t& lastFile, uint64_t& lastOffset,
+                             uint32_t file, uint64_t offset) {
+	putVarint(out, file - lastFile);
+	putVarint(out, file == lastFile ? offset - lastOffset : offset);
+	lastFile = file;
+	lastOffset = offset;
+}
+
+/* 写出索引文件：postings为各倒排表依次拼接的片段。先写临时文件再rename，返回是否成功 */
+inline bool writeIdentifierIndex(const std::string& path,
+                                 const std::vector<IdentifierFileRecord>& fileRecords,
+                                 const std::vector<IdentifierSymbolRecord>& symbolRecords,
+                                 const std::string& pool,
+                                 const std::vector<const std::string*>& postings) {
+	uint64_t postingBytes = 0;
+	for (size_t i = 0; i < postings.size(); i++) postingBytes += postings[i]->size();
+
+	IdentifierIndexHeader header;
+	memcpy(header.magic, "LXI1", 4);
+	header.version = identifierIndexVersion;
+	header.fileCount = (uint32_t)fileRecords.size();
+	header.symbolCount = (uint32_t)symbolRecords.size();
+	header.fileTable = sizeof(header);
+	header.symbolTable = header.fileTable + fileRecords.size() * sizeof(IdentifierFileRecord);
+	header.stringPool = header.symbolTable + symbolRecords.size() * sizeof(IdentifierSymbolRecord);
+	header.postings = header.stringPool + pool.size();
+	header.totalSize = header.postings + postingBytes;
+
+	std::string tmp = path + ".tmp";
+	FILE* f = fopen(tmp.c_str(), "wb");
+	if (f == nullptr) return false;
+	bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+	          (fileRecords.empty() ||
+	           fwrite(fileRecords.data(), sizeof(IdentifierFileRecord), fileRecords.size(), f) == fileRecords.size()) &&
+	          (symbolRecords.empty() ||
+	           fwrite(symbolRecords.data(), sizeof(IdentifierSymbolRecord), symbolRecords.size(), f) == symbolRecords.size()) &&
+	          (pool.empty() || fwrite(pool.data(), 1, pool.size(), f) == pool.size());
+	for (size_t i = 0; ok && i < postings.size(); i++) {
+		ok = postings[i]->empty() || fwrite(postings[i]->data(), 1, postings[i]->size(), f) == postings[i]->size();
+	}
+	ok = (fclose(f) == 0) && ok;
+	if (!ok || rename(tmp.c_str(), path.c_str()) != 0) {
+		unlink(tmp.c_str());
+		return false;
+	}
+	return true;
+}
+
+/* 索引的构建：出现位置必须按(文件, 偏移)递增的顺序加入 */
+class IdentifierIndexBuilder {
+private:
+	struct Symbol {
+		std::string postings;
+		uint32_t count;
+		uint32_t lastFile;
+		uint64_t lastOffset;
+	};
+	std::vector<std::string> files;
+	std::unordered_map<std::string, Symbol> symbols;
+
+public:
+	/* 登记一个文件，返回文件编号 */
+	uint32_t addFile(const std::string& name) {
+		files.push_back(name);
+		return (uint32_t)files.size() - 1;
+	}
+
+	/* 记录一次出现 */
+	void add(const std::string& name, uint32_t file, uint64_t offset) {
+		std::unordered_map<std::string, Symbol>::iterator it = symbols.find(name);
+		if (it == symbols.end()) {
+			Symbol s = {std::string(), 0, 0, 0};
+			it = symbols.insert(std::make_pair(name, s)).first;
+		}
+		Symbol& s = it->second;
+		encodeOccurrence(s.postings, s.lastFile, s.lastOffset, file, offset);
+		s.count++;
+	}
+
+	size_t fileCount() const {
+		return files.size();
+	}
+
+	size_t symbolCount() const {
+		return symbols.size();
+	}
+
+	/* 写出索引文件：先写临时文件再rename，返回是否成功 */
+	bool write(const std::string& path) const {
+		std::vector<const std::pair<const std::string, Symbol>*> sorted;
+		sorted.reserve(symbols.size());
+		for (std::unordered_map<std::string, Symbol>::const_iterator it = symbols.begin();
+		     it != symbols.end(); ++it) {
+			sorted.push_back(&*it);
+		}
+		std::sort(sorted.begin(), sorted.end(),
+		          [](const std::pair<const std::string, Symbol>* a,
+		             const std::pair<const std::string, Symbol>* b) {
+			return a->first < b->first;
+		});
+
+		std::string pool;
+		std::vector<IdentifierFileRecord> fileRecords(files.size());
+		for (size_t i = 0; i < files.size(); i++) {
+			fileRecords[i].nameOffset = pool.size();
+			fileRecords[i].nameLength = (uint32_t)files[i].size();
+			fileRecords[i].reserved = 0;
+			pool += files[i];
+		}
+		std::vector<IdentifierSymbolRecord> symbolRecords(sorted.size());
+		uint64_t postingBytes = 0;
+		for (size_t i = 0; i < sorted.size(); i++) {
+			const Symbol& s = sorted[i]->second;
+			symbolRecords[i].nameOffset = pool.size();
+			symbolRecords[i].nameLength = (uint32_t)sorted[i]->first.size();
+			symbolRecords[i].count = s.count;
+			symbolRecords[i].postingOffset = postingBytes;
+			symbolRecords[i].postingLength = s.postings.size();
+			symbolRecords[i].lastFile = s.lastFile;
+			symbolRecords[i].reserved = 0;
+			pool += sorted[i]->first;
+			postingBytes += s.postings.size();
+		}
+
+		std::vector<const std::string*> postingList(sorted.size());
+		for (size_t i = 0; i < sorted.size(); i++) postingList[i] = &sorted[i]->second.postings;
+		return writeIdentifierIndex(path, fileRecords, symbolRecords, pool, postingList);
+	}
+};
+
+/* 索引文件的读取：mmap整个文件，符号表按名称二分查找 */
+class IdentifierIndexReader {
+private:
+	void* map;
+	size_t size;
+	const IdentifierIndexHeader* header;
+	const IdentifierFileRecord* fileRecords;
+	const IdentifierSymbolRecord* symbolRecords;
+	const char* pool;
+	const unsigned char* postingData;
+
+	/* 校验文件头和所有表项的边界，避免损坏的文件导致越界读 */
+	bool validate() const {
+		if (size < sizeof(IdentifierIndexHeader)) return false;
+		const IdentifierIndexHeader& h = *header;
+		if (memcmp(h.magic, "LXI1", 4) != 0 || h.version != identifierIndexVersion ||
+		    h.totalSize != size || h.fileTable != sizeof(IdentifierIndexHeader) ||
+		    h.symbolTable != h.fileTable + (uint64_t)h.fileCount * sizeof(IdentifierFileRecord) ||
+		    h.stringPool != h.symbolTable + (uint64_t)h.symbolCount * sizeof(IdentifierSymbolRecord) ||
+		    h.postings < h.stringPool || h.postings > size) {
+			return false;
+		}
+		uint64_t poolSize = h.postings - h.stringPool;
+		uint64_t postingSize = size - h.postings;
+		for (uint32_t i = 0; i < h.fileCount; i++) {
+			const IdentifierFileRecord& r = fileRecords[i];
+			if (r.nameOffset > poolSize || r.nameLength > poolSize - r.nameOffset) return false;
+		}
+		for (uint32_t i = 0; i < h.symbolCount; i++) {
+			const IdentifierSymbolRecord& r = symbolRecords[i];
+			if (r.nameOffset > poolSize || r.nameLength > poolSize - r.nameOffset ||
+			    r.postingOffset > postingSize || r.postingLength > postingSize - r.postingOffset ||
+			    (h.fileCount > 0 && r.lastFile >= h.fileCount)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+public:
+	IdentifierIndexReader()
+		: map(nullptr), size(0), header(nullptr), fileRecords(nullptr), symbolRecords(nullptr),
+		  pool(nullptr), postingData(nullptr) {}
+
+	~IdentifierIndexReader() {
+		close();
+	}
+
+	/* 持有mmap映射，禁止拷贝 */
+	IdentifierIndexReader(const IdentifierIndexReader&) = delete;
+	IdentifierIndexReader& operator=(const IdentifierIndexReader&) = delete;
+
+	/* 打开索引文件，文件不存在或格式不对时返回false */
+	bool open(const std::string& path) {
+		close();
+		int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0) return false;
+		struct stat st;
+		if (fstat(fd, &st) != 0 || st.st_size == 0) {
+			::close(fd);
+			return false;
+		}
+		size = (size_t)st.st_size;
+		map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		::close(fd);
+		if (map == MAP_FAILED) {
+			map = nullptr;
+			return false;
+		}
+		const char* base = (const char*)map;
+		header = (const IdentifierIndexHeader*)base;
+		if (size >= sizeof(IdentifierIndexHeader) && header->symbolTable <= size &&
+		    header->stringPool <= size && header->postings <= size) {
+			fileRecords = (const IdentifierFileRecord*)(base + header->fileTable);
+			symbolRecords = (const IdentifierSymbolRecord*)(base + header->symbolTable);
+			pool = base + header->stringPool;
+			postingData = (const unsigned char*)(base + header->postings);
+		}
+		if (fileRecords == nullptr || !validate()) {
+			close();
+			return false;
+		}
+		return true;
+	}
+
+	void close() {
+		if (map != nullptr) munmap(map, size);
+		map = nullptr;
+		size = 0;
+		header = nullptr;
+		fileRecords = nullptr;
+		symbolRecords = nullptr;
+		pool = nullptr;
+		postingData = nullptr;
+	}
+
+	uint32_t fileCount() const {
+		return header->fileCount;
+	}
+
+	uint32_t symbolCount() const {
+		return header->symbolCount;
+	}
+
+	std::string fileName(uint32_t file) const {
+		return std::string(pool + fileRecords[file].nameOffset, fileRecords[file].nameLength);
+	}
+
+	std::string symbolName(uint32_t symbol) const {
+		return std::string(pool + symbolRecords[symbol].nameOffset, symbolRecords[symbol].nameLength);
+	}
+
+	const IdentifierSymbolRecord& symbol(uint32_t i) const {
+		return symbolRecords[i];
+	}
+
+	/* 倒排表的原始编码 */
+	const unsigned char* postingBytes(uint32_t i) const {
+		return postingData + symbolRecords[i].postingOffset;
+	}
+
+	/* 二分查找符号，找不到时返回-1 */
+	long findSymbol(const std::string& name) const {
+		uint32_t lo = 0, hi = header->symbolCount;
+		while (lo < hi) {
+			uint32_t mid = lo + (hi - lo) / 2;
+			const IdentifierSymbolRecord& r = symbolRecords[mid];
+			int cmp = memcmp(pool + r.nameOffset, name.data(), std::min<size_t>(r.nameLength, name.size()));
+			if (cmp == 0) cmp = (r.nameLength < name.size()) ? -1 : (r.nameLength > name.size() ? 1 : 0);
+			if (cmp == 0) return mid;
+			if (cmp < 0) lo = mid + 1;
+			else hi = mid;
+		}
+		return -1;
+	}
+
+	/* 解码一个符号的全部出现位置，编码损坏时返回false */
+	bool occurrences(uint32_t i, std::vector<IdentifierOccurrence>& out) const {
+		const IdentifierSymbolRecord& r = symbolRecords[i];
+		const unsigned char* p = postingBytes(i);
+		const unsigned char* end = p + r.postingLength;
+		uint64_t file = 0, offset = 0;
+		out.clear();
+		while (p < end) {
+			uint64_t fileDelta, value;
+			if (!getVarint(p, end, fileDelta) || !getVarint(p, end, value)) return false;
+			file += fileDelta;
+			offset = (fileDelta == 0) ? offset + value : value;
+			if (file >= header->fileCount) return false;
+			IdentifierOccurrence o = {(uint32_t)file, offset};
+			out.push_back(o);
+		}
+		return out.size() == r.count;
+	}
+};
+
+/* 合并多个索引文件，输入按文件编号的先后顺序给出，合并后文件编号依次顺延。
+   按名称多路归并符号表；每个倒排表只需改写第一个文件差分，其余字节原样复制 */
+inline bool mergeIdentifierIndexes(const std::vector<std::string>& inputs, const std::string& output) {
+	std::vector<IdentifierIndexReader*> readers;
+	bool ok = true;
+	for (size_t i = 0; i < inputs.size() && ok; i++) {
+		readers.push_back(new IdentifierIndexReader());
+		ok = readers.back()->open(inputs[i]);
+	}
+
+	std::string pool, postings;
+	std::vector<IdentifierFileRecord> fileRecords;
+	std::vector<uint32_t> fileBase(readers.size(), 0);
+	for (size_t i = 0; ok && i < readers.size(); i++) {
+		fileBase[i] = (uint32_t)fileRecords.size();
+		for (uint32_t f = 0; f < readers[i]->fileCount(); f++) {
+			std::string name = readers[i]->fileName(f);
+			IdentifierFileRecord r = {pool.size(), (uint32_t)name.size(), 0};
+			fileRecords.push_back(r);
+			pool += name;
+		}
+	}
+
+	std::vector<IdentifierSymbolRecord> symbolRecords;
+	std::vector<uint32_t> cursor(readers.size(), 0);
+	while (ok) {
+		// 找出各输入当前位置上最小的符号名
+		std::string smallest;
+		bool found = false;
+		for (size_t i = 0; i < readers.size(); i++) {
+			if (cursor[i] < readers[i]->symbolCount()) {
+				std::string name = readers[i]->symbolName(cursor[i]);
+				if (!found || name < smallest) {
+					smallest = name;
+					found = true;
+				}
+			}
+		}
+		if (!found) break;
+
+		IdentifierSymbolRecord out = {pool.size(), (uint32_t)smallest.size(), 0, postings.size(), 0, 0, 0};
+		pool += smallest;
+		bool first = true;
+		for (size_t i = 0; i < readers.size() && ok; i++) {
+			if (cursor[i] >= readers[i]->symbolCount() || readers[i]->symbolName(cursor[i]) != smallest) {
+				continue;
+			}
+			const IdentifierSymbolRecord& r = readers[i]->symbol(cursor[i]);
+			const unsigned char* p = readers[i]->postingBytes(cursor[i]);
+			const unsigned char* end = p + r.postingLength;
+			uint64_t localFile;
+			if (r.count == 0 || !getVarint(p, end, localFile) || localFile >= readers[i]->fileCount()) {
+				ok = false;
+				break;
+			}
+			// 改写第一个文件差分：相对于已合并部分的最后一个文件。不同输入的文件互不相同，
+			// 差分必然大于0，原编码中第一个偏移本来就是绝对偏移，无需改写
+			uint32_t globalFile = fileBase[i] + (uint32_t)localFile;
+			uint32_t previous = first ? 0 : out.lastFile;
+			if (!first && globalFile <= previous) {
+				ok = false;
+				break;
+			}
+			putVarint(postings, globalFile - previous);
+			postings.append((const char*)p, end - p);
+			out.count += r.count;
+			out.lastFile = fileBase[i] + r.lastFile;
+			first = false;
+			cursor[i]++;
+		}
+		out.postingLength = postings.size() - out.postingOffset;
+		symbolRecords.push_back(out);
+	}
+
+	if (ok) {
+		std::vector<const std::string*> postingList(1, &postings);
+		ok = writeIdentifierIndex(output, fileRecords, symbolRecords, pool, postingList);
+	}
+
+	for (size_t i = 0; i < readers.size(); i++) delete readers[i];
+	return ok;
+}
+
+#endif
@@ -0,0 +1,81 @@
+// 词法分析器的语言配置
+// BasicLexicalAnalyzer<Profile>按配置在编译期裁剪：关键字表、启用的运算符/界符和可选特性
+// 都是编译期常量，未启用的分支在实例化时被常量折叠掉，不再有运行时判断。
+//
+// 一个配置需要提供：
+//   blockComments / lineComments     是否识别块注释、行注释
+//   strings                          是否识别字符串（"作为界符，内容作为标识符）
+//   numberFractions                  是否识别小数部分（3.14）
+//   numberExponents / numberSuffixes 是否识别指数（1e10）和后缀（10L、1.5f）
+//   unicodeIdentifiers               是否识别UTF-8标识符
+//   hasSymbol(code)                  某个运算符/界符（编号33~77）是否启用；
+//                                    多字符运算符要求其每个前缀也启用（如<<=要求<和<<）
+//   keywords() / keywordCount        关键字表
+#ifndef LANGUAGE_PROFILE_H
+#define LANGUAGE_PROFILE_H
+
+/* 关键字表项 */
+struct ProfileKeyword {
+	const char* word;
+	int code;
+};
+
+/* 完整的C语言：32个关键字、全部运算符和界符、注释、字符串 */
+struct CProfile {
+	static constexpr bool blockComments = true;
+	static constexpr bool lineComments = true;
+	static constexpr bool strings = true;
+	static constexpr bool numberFractions = true;
+	static constexpr bool numberExponents = true;
+	static constexpr bool numberSuffixes = true;
+	static constexpr bool unicodeIdentifiers = true;
+
+	static constexpr bool hasSymbol(int code) {
+		return code >= 33 && code <= 77;
+	}
+
+	static constexpr int keywordCount = 32;
+	static const ProfileKeyword* keywords() {
+		static const ProfileKeyword list[keywordCount] = {
+			{"auto", 1}, {"break", 2}, {"case", 3}, {"char", 4},
+			{"const", 5}, {"continue", 6}, {"default", 7}, {"do", 8},
+			{"double", 9}, {"else", 10}, {"enum", 11}, {"extern", 12},
+			{"float", 13}, {"for", 14}, {"goto", 15}, {"if", 16},
+			{"int", 17}, {"long", 18}, {"register", 19}, {"return", 20},
+			{"short", 21}, {"signed", 22}, {"sizeof", 23}, {"static", 24},
+			{"struct", 25}, {"switch", 26}, {"typedef", 27}, {"union", 28},
+			{"unsigned", 29}, {"void", 30}, {"volatile", 31}, {"while", 32}
+		};
+		return list;
+	}
+};
+
+/* 实验二~四的子集文法：15个运算符/界符、6个关键字，没有注释和字符串
+   沿用C语言的编号，C中没有的关键字then、real从82开始编号 */
+struct SubsetProfile {
+	static constexpr bool blockComments = false;
+	static constexpr bool lineComments = false;
+	static constexpr bool strings = false;
+	static constexpr bool numberFractions = true;   // 实验四的实数
+	static constexpr bool numberExponents = false;
+	static constexpr bool numberSuffixes = false;
+	static constexpr bool unicodeIdentifiers = false;
+
+	// - ( ) * / ; { } + < <= = == > >=
+	static constexpr bool hasSymbol(int code) {
+		return code == 33 || code == 44 || code == 45 || code == 46 || code == 50 ||
+		       code == 53 || code == 59 || code == 63 || code == 65 || code == 68 ||
+		       code == 71 || code == 72 || code == 73 || code == 74 || code == 75;
+	}
+
+	static constexpr int keywordCount = 6;
+	static const ProfileKeyword* keywords() {
+		static const ProfileKeyword list[keywordCount] = {
+			{"else", 10}, {"if", 16}, {"int", 17}, {"while", 32},
+			{"then", 82}, {"real", 83}
+		};
+		return list;
+	}
+};
+
+#endif
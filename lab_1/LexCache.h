@@ -0,0 +1,209 @@
+// 词法分析结果缓存
+// 以源程序内容的128位哈希为键，把Token流序列化到缓存目录中；命中时通过mmap直接读取，
+// 无需重新扫描。哈希以分析器标识为种子，文件头中也记录该标识，词法规则或语言配置不同的
+// 分析器（如不同分支、不同版本的构建）共享一个缓存目录时不会读到彼此的结果。
+// 写入采用临时文件+fsync+rename保证原子性，崩溃后不会留下内容不完整的正式文件；
+// 多个进程可以共享同一个缓存目录，目录总大小超过上限时按最近使用时间（mtime）淘汰。
+#ifndef LEX_CACHE_H
+#define LEX_CACHE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+#include "LexHash.h"
+
+/* 缓存文件中的一个Token记录，内容为源程序中的[offset, offset + length) */
+struct LexCacheRecord {
+	uint64_t offset;
+	uint64_t length;
+	int32_t code;
+	int32_t line;
+};
+
+/* 缓存文件头 */
+struct LexCacheHeader {
+	char magic[4];          // "LXC1"
+	uint32_t version;       // 格式版本
+	uint64_t lexerId;       // 分析器标识，见BasicLexicalAnalyzer::fingerprint()
+	uint64_t inputLength;   // 源程序长度，命中时再次校验
+	uint64_t tokenCount;    // 记录个数
+	LexHash128 hash;        // 源程序哈希，防止文件名与内容不符
+};
+
+static const uint32_t lexCacheVersion = 2;
+
+/* 内容寻址的词法分析结果缓存 */
+class LexCache {
+private:
+	std::string dir;        // 缓存目录
+	uint64_t maxBytes;      // 目录总大小上限
+	uint64_t lexerId;       // 分析器标识
+	LexHash128 key;         // 当前源程序的哈希，以分析器标识为种子
+	uint64_t inputLength;   // 当前源程序的长度
+	std::string path;       // 当前源程序对应的缓存文件
+
+	/* 缓存文件名：32位十六进制哈希 + .lexc */
+	static std::string fileName(const LexHash128& h) {
+		char buf[40];
+		snprintf(buf, sizeof(buf), "%016llx%016llx.lexc",
+		         (unsigned long long)h.hi, (unsigned long long)h.lo);
+		return buf;
+	}
+
+	static bool endsWith(const std::string& s, const char* suffix) {
+		size_t n = strlen(suffix);
+		return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+	}
+
+	/* 完整写入，处理被信号打断的短写 */
+	static bool writeAll(int fd, const char* data, size_t len) {
+		while (len > 0) {
+			ssize_t n = write(fd, data, len);
+			if (n <= 0) return false;
+			data += n;
+			len -= (size_t)n;
+		}
+		return true;
+	}
+
+	/* 按mtime淘汰最久未使用的缓存文件，直到总大小不超过上限；同时清理崩溃遗留的临时文件 */
+	void evict() {
+		DIR* d = opendir(dir.c_str());
+		if (d == nullptr) return;
+
+		struct Entry {
+			std::string path;
+			time_t mtime;
+			uint64_t size;
+		};
+		std::vector<Entry> entries;
+		uint64_t total = 0;
+		time_t now = time(nullptr);
+
+		while (struct dirent* e = readdir(d)) {
+			std::string name = e->d_name;
+			std::string full = dir + "/" + name;
+			struct stat st;
+			if (stat(full.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) continue;
+			if (endsWith(name, ".lexc")) {
+				Entry entry = {full, st.st_mtime, (uint64_t)st.st_size};
+				entries.push_back(entry);
+				total += st.st_size;
+			} else if (name.find(".lexc.tmp.") != std::string::npos && now - st.st_mtime > 3600) {
+				unlink(full.c_str());
+			}
+		}
+		closedir(d);
+
+		if (total <= maxBytes) return;
+		std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+			return a.mtime < b.mtime;
+		});
+		// 其他进程可能同时在淘汰，unlink失败（文件已被删除）直接忽略；
+		// 正在通过mmap读取的进程不受影响
+		for (size_t i = 0; i < entries.size() && total > maxBytes; i++) {
+			unlink(entries[i].path.c_str());
+			total -= entries[i].size;
+		}
+	}
+
+public:
+	LexCache(const std::string& cacheDir, uint64_t limit, const std::string& source, uint64_t lexer)
+		: dir(cacheDir), maxBytes(limit), lexerId(lexer), inputLength(source.size()) {
+		key = lexHash128(source.data(), source.size(), lexerId);
+		path = dir + "/" + fileName(key);
+	}
+
+	/* 查找缓存，命中时按Analysis()的格式输出并返回true */
+	bool printCached(const std::string& source, std::ostream& out) {
+		int fd = open(path.c_str(), O_RDONLY);
+		if (fd < 0) return false;
+
+		struct stat st;
+		if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(LexCacheHeader)) {
+			close(fd);
+			return false;
+		}
+		size_t size = (size_t)st.st_size;
+		void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+		if (map == MAP_FAILED) return false;
+
+		// 先完整校验文件头和所有记录，避免输出一半才发现文件损坏
+		const LexCacheHeader* header = (const LexCacheHeader*)map;
+		const LexCacheRecord* records = (const LexCacheRecord*)((const char*)map + sizeof(LexCacheHeader));
+		bool valid = memcmp(header->magic, "LXC1", 4) == 0 &&
+		             header->version == lexCacheVersion &&
+		             header->lexerId == lexerId &&
+		             header->inputLength == source.size() &&
+		             header->hash.lo == key.lo && header->hash.hi == key.hi &&
+		             header->tokenCount == (size - sizeof(LexCacheHeader)) / sizeof(LexCacheRecord) &&
+		             (size - sizeof(LexCacheHeader)) % sizeof(LexCacheRecord) == 0;
+		for (uint64_t i = 0; valid && i < header->tokenCount; i++) {
+			valid = records[i].offset <= source.size() &&
+			        records[i].length <= source.size() - records[i].offset;
+		}
+
+		if (valid) {
+			for (uint64_t i = 0; i < header->tokenCount; i++) {
+				out << (i + 1) << ": <";
+				out.write(source.data() + records[i].offset, records[i].length);
+				out << "," << records[i].code << ">";
+				// 注意：最后一行后面不能有回车
+				if (i < header->tokenCount - 1) {
+					out << "\n";
+				}
+			}
+			// 更新mtime，作为LRU淘汰的最近使用时间
+			utimes(path.c_str(), nullptr);
+		}
+		munmap(map, size);
+		return valid;
+	}
+
+	/* 写入缓存：先写临时文件并fsync，再rename为正式文件名，读者不会看到写了一半的文件，
+	   崩溃后也不会出现已改名但数据未落盘的截断文件 */
+	void store(const std::vector<LexCacheRecord>& records) {
+		mkdir(dir.c_str(), 0755);
+
+		LexCacheHeader header;
+		memcpy(header.magic, "LXC1", 4);
+		header.version = lexCacheVersion;
+		header.lexerId = lexerId;
+		header.inputLength = inputLength;
+		header.tokenCount = records.size();
+		header.hash = key;
+
+		char suffix[64];
+		struct timeval tv;
+		gettimeofday(&tv, nullptr);
+		snprintf(suffix, sizeof(suffix), ".tmp.%ld.%ld", (long)getpid(), (long)tv.tv_usec);
+		std::string tmp = path + suffix;
+
+		int fd = open(tmp.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0644);
+		if (fd < 0) return;
+		bool ok = writeAll(fd, (const char*)&header, sizeof(header)) &&
+		          (records.empty() ||
+		           writeAll(fd, (const char*)records.data(), records.size() * sizeof(LexCacheRecord)));
+		ok = ok && fsync(fd) == 0;
+		ok = (close(fd) == 0) && ok;
+		if (!ok || rename(tmp.c_str(), path.c_str()) != 0) {
+			unlink(tmp.c_str());
+			return;
+		}
+		evict();
+	}
+};
+
+#endif
@@ -0,0 +1,74 @@
+// 词法分析用的128位哈希（MurmurHash3_x64_128）
+// LexCache.h用它计算源程序的缓存键，BasicLexicalAnalyzer.h用它计算分析器标识；
+// 单独成文件，使只用哈希的代码不必引入缓存的文件操作和mmap
+#ifndef LEX_HASH_H
+#define LEX_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/* 128位哈希值 */
+struct LexHash128 {
+	uint64_t lo;
+	uint64_t hi;
+};
+
+inline uint64_t lexRotl64(uint64_t x, int r) {
+	return (x << r) | (x >> (64 - r));
+}
+
+inline uint64_t lexFmix64(uint64_t k) {
+	k ^= k >> 33;
+	k *= 0xff51afd7ed558ccdULL;
+	k ^= k >> 33;
+	k *= 0xc4ceb9fe1a85ec53ULL;
+	k ^= k >> 33;
+	return k;
+}
+
+/* MurmurHash3_x64_128：快速的128位非加密哈希，每次处理16字节 */
+inline LexHash128 lexHash128(const char* data, size_t len, uint64_t seed = 0) {
+	const uint64_t c1 = 0x87c37b91114253d5ULL;
+	const uint64_t c2 = 0x4cf5ad432745937fULL;
+	uint64_t h1 = seed, h2 = seed;
+	size_t nblocks = len / 16;
+
+	for (size_t i = 0; i < nblocks; i++) {
+		uint64_t k1, k2;
+		memcpy(&k1, data + i * 16, 8);
+		memcpy(&k2, data + i * 16 + 8, 8);
+
+		k1 *= c1; k1 = lexRotl64(k1, 31); k1 *= c2; h1 ^= k1;
+		h1 = lexRotl64(h1, 27); h1 += h2; h1 = h1 * 5 + 0x52dce729;
+		k2 *= c2; k2 = lexRotl64(k2, 33); k2 *= c1; h2 ^= k2;
+		h2 = lexRotl64(h2, 31); h2 += h1; h2 = h2 * 5 + 0x38495ab5;
+	}
+
+	// 处理剩余不足16字节的尾部
+	const unsigned char* tail = (const unsigned char*)(data + nblocks * 16);
+	uint64_t k1 = 0, k2 = 0;
+	size_t rest = len & 15;
+	for (size_t i = rest; i > 8; i--) {
+		k2 ^= (uint64_t)tail[i - 1] << ((i - 9) * 8);
+	}
+	if (rest > 8) {
+		k2 *= c2; k2 = lexRotl64(k2, 33); k2 *= c1; h2 ^= k2;
+	}
+	for (size_t i = (rest < 8 ? rest : 8); i > 0; i--) {
+		k1 ^= (uint64_t)tail[i - 1] << ((i - 1) * 8);
+	}
+	if (rest > 0) {
+		k1 *= c1; k1 = lexRotl64(k1, 31); k1 *= c2; h1 ^= k1;
+	}
+
+	h1 ^= len; h2 ^= len;
+	h1 += h2; h2 += h1;
+	h1 = lexFmix64(h1); h2 = lexFmix64(h2);
+	h1 += h2; h2 += h1;
+
+	LexHash128 result = {h1, h2};
+	return result;
+}
+
+#endif
@@ -0,0 +1,26 @@
+// 模糊测试公共部分：不变式检查宏与字节分类
+#ifndef FUZZ_CHECK_H
+#define FUZZ_CHECK_H
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/* 不变式被破坏时打印原因并abort()，libFuzzer会把当前输入保存为crash-文件 */
+#define FUZZ_CHECK(cond, msg) \
+    do { \
+        if (!(cond)) { \
+            fprintf(stderr, "不变式被破坏: %s (%s:%d)\n", msg, __FILE__, __LINE__); \
+            abort(); \
+        } \
+    } while (0)
+
+/* ASCII字节能否作为某个Token的开头：字母、数字、下划线、引号、运算符和界符 */
+inline bool asciiStartsToken(unsigned char c) {
+    if (c == '\0' || c >= 0x80) return false;
+    return isalnum(c) || c == '_' || c == '"' ||
+           strchr("-!%&*/^|+<=>(),.:;?[]{}~", c) != nullptr;
+}
+
+#endif
@@ -0,0 +1,98 @@
+// LexicalAnalyzer的libFuzzer入口
+// 检查的不变式：
+// 1. Token按偏移递增排列、互不重叠，内容与源程序对应位置逐字节相同
+// 2. Token之间被跳过的字节只能是空白或无法识别的字节
+// 3. 每个Token的行号等于其起始偏移之前的换行数加1
+// 4. 增量模式nextToken()、推送模式feed()/finish()与一次性analyze()得到完全相同的Token序列
+
+#include "../LexAnalysis.h"
+#include "fuzz_check.h"
+#include <cstdint>
+
+/* 词法分析器是否允许跳过pos处的字节 */
+static bool lexerMaySkip(const char* input, size_t size, size_t pos) {
+    unsigned char c = (unsigned char)input[pos];
+    if (c < 0x80) {
+        return isspace(c) || !asciiStartsToken(c);
+    }
+    // 非ASCII字节：只有不能构成XID_Start字符时才会被跳过
+    unsigned int cp = 0;
+    int len = decodeUtf8(input + pos, size - pos, cp);
+    return len == 0 || !isXidStart(cp);
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    const char* input = (const char*)data;
+
+    LexicalAnalyzer analyzer(input, size);
+    analyzer.analyze();
+    const vector<Token>& tokens = analyzer.getTokens();
+
+    size_t cursor = 0;
+    int line = 1;
+    for (size_t i = 0; i < tokens.size(); i++) {
+        const Token& t = tokens[i];
+        FUZZ_CHECK(!t.name.empty(), "出现空Token");
+        FUZZ_CHECK(t.code >= 1 && t.code <= 81, "种别码越界");
+        FUZZ_CHECK(t.offset >= cursor, "Token偏移倒退或与前一个Token重叠");
+        FUZZ_CHECK(t.offset <= size && t.name.size() <= size - t.offset, "Token超出输入范围");
+
+        for (; cursor < t.offset; cursor++) {
+            FUZZ_CHECK(lexerMaySkip(input, size, cursor), "跳过了可以识别的字节");
+            if (input[cursor] == '\n') line++;
+        }
+        FUZZ_CHECK(memcmp(input + t.offset, t.name.data(), t.name.size()) == 0,
+                   "Token内容与源程序不符");
+        FUZZ_CHECK(t.line == line, "Token行号与之前的换行数不符");
+
+        for (size_t j = 0; j < t.name.size(); j++) {
+            if (t.name[j] == '\n') line++;
+        }
+        cursor += t.name.size();
+    }
+    for (; cursor < size; cursor++) {
+        FUZZ_CHECK(lexerMaySkip(input, size, cursor), "输入末尾有未识别的Token");
+    }
+
+    // 增量模式必须与一次性分析结果一致
+    LexicalAnalyzer streaming(input, size);
+    size_t count = 0;
+    while (const Token* t = streaming.nextToken()) {
+        FUZZ_CHECK(count < tokens.size(), "增量模式产生了多余的Token");
+        const Token& expected = tokens[count++];
+        FUZZ_CHECK(t->name == expected.name && t->code == expected.code &&
+                   t->offset == expected.offset && t->line == expected.line,
+                   "增量模式的Token与analyze()不同");
+    }
+    FUZZ_CHECK(count == tokens.size(), "增量模式缺少Token");
+
+    // 推送模式：逐字节输入，以及按输入内容决定的不规则分段输入，都必须与一次性分析结果一致
+    for (int mode = 0; mode < 2; mode++) {
+        LexicalAnalyzer pushing;
+        vector<Token> pushed;
+        size_t fed = 0;
+        uint32_t state = (uint32_t)size * 2654435761u;
+        while (fed < size) {
+            size_t chunk = 1;
+            if (mode == 1) {
+                state = state * 1103515245u + 12345u;
+                chunk = 1 + (state >> 16) % 17;
+            }
+            if (chunk > size - fed) chunk = size - fed;
+            const vector<Token>& part = pushing.feed(input + fed, chunk);
+            pushed.insert(pushed.end(), part.begin(), part.end());
+            fed += chunk;
+        }
+        const vector<Token>& rest = pushing.finish();
+        pushed.insert(pushed.end(), rest.begin(), rest.end());
+
+        FUZZ_CHECK(pushed.size() == tokens.size(), "推送模式的Token数与analyze()不同");
+        for (size_t i = 0; i < tokens.size(); i++) {
+            FUZZ_CHECK(pushed[i].name == tokens[i].name && pushed[i].code == tokens[i].code &&
+                       pushed[i].offset == tokens[i].offset && pushed[i].line == tokens[i].line,
+                       "推送模式的Token与analyze()不同");
+        }
+    }
+
+    return 0;
+}
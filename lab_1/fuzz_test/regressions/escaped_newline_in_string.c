@@ -0,0 +1,3 @@
+char *s = "line one \
+line two";
+int x;
@@ -0,0 +1,58 @@
+#!/bin/bash
+
+# 词法分析器模糊测试脚本
+# 用法: ./run_fuzz.sh [lexer|visualizer|all] [秒数]
+# 有clang++时用libFuzzer + ASan/UBSan，否则用g++ + ASan/UBSan链接独立驱动程序
+# 崩溃、超时（-timeout）和内存超限（-rss_limit_mb）的输入保存到regressions/，之后每次运行都会先回放
+
+TARGET=${1:-all}
+DURATION=${2:-60}
+TIMEOUT=2
+RSS_LIMIT_MB=512
+MAX_LEN=65536
+SEEDS=../test_automation/test_cases
+
+if [ "$TARGET" = "all" ]; then
+    TARGETS="lexer visualizer"
+else
+    TARGETS="$TARGET"
+fi
+
+mkdir -p regressions corpus
+export ASAN_OPTIONS=abort_on_error=1
+export UBSAN_OPTIONS=halt_on_error=1:print_stacktrace=1
+
+status=0
+for t in $TARGETS; do
+    echo "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━"
+    echo "模糊测试: ${t}"
+    echo "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━"
+
+    if command -v clang++ > /dev/null; then
+        clang++ -std=c++11 -g -O1 -fsanitize=fuzzer,address,undefined \
+            -o ${t}_fuzzer ${t}_fuzzer.cpp || exit 1
+        # 先回放回归用例，再从种子语料开始变异，新发现的输入写入corpus/
+        if ls regressions/* > /dev/null 2>&1; then
+            ./${t}_fuzzer -timeout=$TIMEOUT -rss_limit_mb=$RSS_LIMIT_MB regressions/* || { status=1; continue; }
+        fi
+        ./${t}_fuzzer corpus $SEEDS -dict=lexer.dict -max_total_time=$DURATION \
+            -timeout=$TIMEOUT -rss_limit_mb=$RSS_LIMIT_MB -max_len=$MAX_LEN \
+            -artifact_prefix=regressions/ || status=1
+    else
+        echo "未找到clang++，使用g++和独立驱动程序（无覆盖率反馈）"
+        g++ -std=c++11 -g -O1 -fsanitize=address,undefined \
+            -o ${t}_fuzzer ${t}_fuzzer.cpp standalone_fuzz_main.cpp || exit 1
+        # 独立驱动程序按次数运行，按每秒约4000次估算
+        ./${t}_fuzzer regressions $SEEDS -runs=$((DURATION * 4000)) \
+            -timeout=$TIMEOUT -rss_limit_mb=$RSS_LIMIT_MB -max_len=4096 \
+            -artifact_prefix=regressions/ || status=1
+    fi
+    echo ""
+done
+
+if [ $status -eq 0 ]; then
+    echo "✓ 未发现问题"
+else
+    echo "✗ 发现问题，触发输入已保存到 regressions/"
+fi
+exit $status
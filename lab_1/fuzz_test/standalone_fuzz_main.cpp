@@ -0,0 +1,261 @@
+// 没有libFuzzer时（例如只有g++）使用的独立驱动程序，与任一*_fuzzer.cpp链接
+// 支持libFuzzer的部分参数：
+//   ./lexer_fuzzer [-runs=N] [-seed=N] [-max_len=N] [-timeout=秒] [-rss_limit_mb=N]
+//                  [-artifact_prefix=前缀] 文件或目录...
+// 先逐个回放给出的输入（种子语料与回归用例），runs大于0时再对种子做随机变异。
+// 没有覆盖率反馈，只能作为libFuzzer的替代；崩溃、超时、内存超限的输入按libFuzzer的
+// 命名规则保存为crash-/timeout-/oom-文件，可直接放入回归目录。
+// 内存超限按单个输入执行期间常驻内存（RSS）的增长判断，不受之前的输入和读入的语料影响。
+
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+using namespace std;
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+/* 当前正在执行的输入，供信号处理函数保存 */
+static const char* currentData = nullptr;
+static size_t currentSize = 0;
+static string artifactPrefix = "./";
+
+/* 当前输入的crash-、timeout-保存路径，执行输入前生成，信号处理函数中不再格式化字符串 */
+static char crashPath[4096];
+static char timeoutPath[4096];
+
+/* 变异时优先插入的片段：注释、字符串、转义、多字符运算符和UTF-8字符 */
+static const char* interestingPieces[] = {
+    "/*", "*/", "//", "\"", "\\", "\\\"", "\\\n", "\n", "\r\n", "\t", " ",
+    "<<=", ">>=", "->", "++", "&&", "!=", "1e+", "0.5", "_", "int", "while",
+    "\xe4\xb8\xad", "\xc3\x97", "\xe2\x80\x8b", "\xf0\x9f\x98\x80", "\xff", "\xc0\x80"
+};
+
+/* FNV-1a哈希，用作保存文件名 */
+static string hashName(const char* data, size_t size) {
+    uint64_t h = 1469598103934665603ULL;
+    for (size_t i = 0; i < size; i++) {
+        h = (h ^ (unsigned char)data[i]) * 1099511628211ULL;
+    }
+    char buf[20];
+    snprintf(buf, sizeof(buf), "%016llx", (unsigned long long)h);
+    return buf;
+}
+
+/* 生成input的crash-、timeout-保存路径（前缀 + 种类 + '-' + 哈希） */
+static void prepareArtifactPaths(const string& input) {
+    string hash = hashName(input.data(), input.size());
+    snprintf(crashPath, sizeof(crashPath), "%scrash-%s", artifactPrefix.c_str(), hash.c_str());
+    snprintf(timeoutPath, sizeof(timeoutPath), "%stimeout-%s", artifactPrefix.c_str(), hash.c_str());
+}
+
+/* 把当前输入保存到path；会在信号处理函数中调用，路径事先生成，
+   这里只使用open/write/close和strlen这些异步信号安全的函数 */
+static void saveArtifact(const char* path) {
+    if (currentData == nullptr) return;
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd >= 0) {
+        size_t done = 0;
+        while (done < currentSize) {
+            ssize_t n = write(fd, currentData + done, currentSize - done);
+            if (n <= 0) break;
+            done += (size_t)n;
+        }
+        close(fd);
+    }
+    const char msg[] = "==standalone== 输入已保存到 ";
+    if (write(2, msg, sizeof(msg) - 1) < 0 || write(2, path, strlen(path)) < 0 ||
+        write(2, "\n", 1) < 0) {
+        // 输出失败也无法补救
+    }
+}
+
+static void onCrash(int sig) {
+    saveArtifact(crashPath);
+    signal(sig, SIG_DFL);
+    raise(sig);
+}
+
+static void onTimeout(int) {
+    const char msg[] = "==standalone== 单个输入超时\n";
+    if (write(2, msg, sizeof(msg) - 1) < 0) {
+        // 忽略
+    }
+    saveArtifact(timeoutPath);
+    _exit(70);
+}
+
+/* 读取文件，目录则读取其中的所有普通文件（不递归） */
+static void loadInputs(const string& path, vector<string>& inputs) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) {
+        cerr << "无法访问: " << path << endl;
+        return;
+    }
+    if (S_ISDIR(st.st_mode)) {
+        DIR* d = opendir(path.c_str());
+        if (d == nullptr) return;
+        vector<string> names;
+        while (struct dirent* e = readdir(d)) {
+            if (e->d_name[0] != '.') names.push_back(path + "/" + e->d_name);
+        }
+        closedir(d);
+        for (size_t i = 0; i < names.size(); i++) {
+            struct stat fst;
+            if (stat(names[i].c_str(), &fst) == 0 && S_ISREG(fst.st_mode)) {
+                loadInputs(names[i], inputs);
+            }
+        }
+        return;
+    }
+    ifstream in(path.c_str(), ios::binary);
+    stringstream ss;
+    ss << in.rdbuf();
+    inputs.push_back(ss.str());
+}
+
+/* 对输入做1~4次随机变异 */
+static string mutate(const vector<string>& seeds, mt19937_64& rng, size_t maxLen) {
+    string s = seeds[rng() % seeds.size()];
+    int rounds = 1 + (int)(rng() % 4);
+    for (int r = 0; r < rounds; r++) {
+        size_t pos = s.empty() ? 0 : rng() % (s.size() + 1);
+        switch (rng() % 6) {
+        case 0:  // 翻转一个字节
+            if (!s.empty()) s[rng() % s.size()] ^= (char)(1 << (rng() % 8));
+            break;
+        case 1:  // 插入随机字节
+            s.insert(pos, 1, (char)(rng() % 256));
+            break;
+        case 2: {  // 插入特殊片段
+            size_t n = sizeof(interestingPieces) / sizeof(interestingPieces[0]);
+            s.insert(pos, interestingPieces[rng() % n]);
+            break;
+        }
+        case 3:  // 删除一段
+            if (!s.empty()) s.erase(rng() % s.size(), 1 + rng() % 16);
+            break;
+        case 4: {  // 重复一段，制造长输入以暴露超线性路径
+            if (s.empty()) break;
+            size_t from = rng() % s.size();
+            string piece = s.substr(from, 1 + rng() % 32);
+            size_t times = 1 + rng() % 64;
+            string repeated;
+            for (size_t i = 0; i < times; i++) repeated += piece;
+            s.insert(pos, repeated);
+            break;
+        }
+        default: {  // 与另一个种子拼接
+            const string& other = seeds[rng() % seeds.size()];
+            s = s.substr(0, pos) + other.substr(other.empty() ? 0 : rng() % other.size());
+            break;
+        }
+        }
+    }
+    if (s.size() > maxLen) s.resize(maxLen);
+    return s;
+}
+
+/* 当前的常驻内存（MB），读/proc/self/statm的第二项（页数）；不支持时返回-1 */
+static long residentMb() {
+    static int fd = open("/proc/self/statm", O_RDONLY);
+    if (fd < 0) return -1;
+    char buf[128];
+    ssize_t n = pread(fd, buf, sizeof(buf) - 1, 0);
+    if (n <= 0) return -1;
+    buf[n] = '\0';
+    unsigned long size = 0, resident = 0;
+    if (sscanf(buf, "%lu %lu", &size, &resident) != 2) return -1;
+    return (long)(resident * (unsigned long)sysconf(_SC_PAGESIZE) / (1024 * 1024));
+}
+
+/* 进程生存期内的峰值常驻内存（MB，Linux的ru_maxrss以KB为单位） */
+static long peakMb() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024;
+}
+
+/* 执行一个输入，超时由SIGALRM处理，内存超限则保存为oom-文件并退出 */
+static void runOne(const string& input, unsigned timeoutSec, long rssLimitMb) {
+    prepareArtifactPaths(input);
+    long before = rssLimitMb > 0 ? residentMb() : -1;
+    long peakBefore = rssLimitMb > 0 ? peakMb() : 0;
+    currentData = input.data();
+    currentSize = input.size();
+    alarm(timeoutSec);
+    LLVMFuzzerTestOneInput((const uint8_t*)input.data(), input.size());
+    alarm(0);
+    if (rssLimitMb > 0) {
+        // 本次执行的RSS增长：执行后比执行前多出的部分；峰值在本次执行中上升时，
+        // 峰值也出现在本次执行中，取新峰值比执行前多出的部分。没有/proc时只能看峰值的上升
+        long after = residentMb();
+        long peakAfter = peakMb();
+        if (before < 0 || after < 0) before = after = peakBefore;
+        long growth = after - before;
+        if (peakAfter > peakBefore && peakAfter - before > growth) growth = peakAfter - before;
+        if (growth > rssLimitMb) {
+            cerr << "==standalone== 内存超限: 单个输入使RSS增长" << growth << "MB" << endl;
+            string path = artifactPrefix + "oom-" + hashName(currentData, currentSize);
+            saveArtifact(path.c_str());
+            exit(71);
+        }
+    }
+    currentData = nullptr;
+}
+
+int main(int argc, char* argv[]) {
+    long runs = 0, rssLimitMb = 2048;
+    unsigned long long seed = 1;
+    size_t maxLen = 4096;
+    unsigned timeoutSec = 1200;
+    vector<string> inputs;
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg.compare(0, 6, "-runs=") == 0) runs = atol(arg.c_str() + 6);
+        else if (arg.compare(0, 6, "-seed=") == 0) seed = strtoull(arg.c_str() + 6, nullptr, 10);
+        else if (arg.compare(0, 9, "-max_len=") == 0) maxLen = strtoul(arg.c_str() + 9, nullptr, 10);
+        else if (arg.compare(0, 9, "-timeout=") == 0) timeoutSec = (unsigned)atoi(arg.c_str() + 9);
+        else if (arg.compare(0, 14, "-rss_limit_mb=") == 0) rssLimitMb = atol(arg.c_str() + 14);
+        else if (arg.compare(0, 17, "-artifact_prefix=") == 0) artifactPrefix = arg.substr(17);
+        else if (arg[0] == '-') cerr << "忽略不支持的参数: " << arg << endl;
+        else loadInputs(arg, inputs);
+    }
+
+    signal(SIGABRT, onCrash);
+    signal(SIGSEGV, onCrash);
+    signal(SIGBUS, onCrash);
+    signal(SIGFPE, onCrash);
+    signal(SIGALRM, onTimeout);
+
+    for (size_t i = 0; i < inputs.size(); i++) {
+        runOne(inputs[i], timeoutSec, rssLimitMb);
+    }
+    cerr << "==standalone== 回放 " << inputs.size() << " 个输入，全部通过" << endl;
+
+    if (runs > 0) {
+        if (inputs.empty()) inputs.push_back("");
+        mt19937_64 rng(seed);
+        auto start = chrono::steady_clock::now();
+        for (long r = 0; r < runs; r++) {
+            runOne(mutate(inputs, rng, maxLen), timeoutSec, rssLimitMb);
+        }
+        double sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cerr << "==standalone== 随机变异 " << runs << " 次，全部通过（" << sec << " 秒）" << endl;
+    }
+    return 0;
+}
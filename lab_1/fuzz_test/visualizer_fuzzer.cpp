@@ -0,0 +1,44 @@
+// 可视化工具中词法分析器副本的libFuzzer入口
+// VisualToken不记录偏移和行号，这里按顺序在源程序中匹配每个Token，检查：
+// 1. 每个Token的内容都能在上一个Token之后找到，中间只隔着空白或无法识别的字节
+// 2. 最后一个Token之后只剩空白或无法识别的字节
+// 换行要么在Token内容中、要么在被跳过的空白中，覆盖检查通过即说明行数守恒
+
+#define VISUALIZER_NO_MAIN
+#include "../visualization_tool/visualizer.cpp"
+#include "fuzz_check.h"
+#include <cstdint>
+
+/* 可视化工具不识别UTF-8标识符，非ASCII字节一律跳过 */
+static bool visualizerMaySkip(unsigned char c) {
+    return c >= 0x80 || isspace(c) || !asciiStartsToken(c);
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    const char* input = (const char*)data;
+
+    VisualLexicalAnalyzer analyzer(string(input, size));
+    analyzer.analyze();
+    const vector<VisualToken>& tokens = analyzer.getTokens();
+
+    size_t cursor = 0;
+    for (size_t i = 0; i < tokens.size(); i++) {
+        const VisualToken& t = tokens[i];
+        FUZZ_CHECK(!t.name.empty(), "出现空Token");
+        FUZZ_CHECK(t.type != "未知", "种别码越界");
+
+        // 字符串内容可能以空白开头，所以先尝试在当前位置匹配，失败才跳过一个字节
+        while (cursor < size && !(t.name.size() <= size - cursor &&
+                                  memcmp(input + cursor, t.name.data(), t.name.size()) == 0)) {
+            FUZZ_CHECK(visualizerMaySkip((unsigned char)input[cursor]), "跳过了可以识别的字节");
+            cursor++;
+        }
+        FUZZ_CHECK(cursor < size, "Token内容在源程序中找不到");
+        cursor += t.name.size();
+    }
+    for (; cursor < size; cursor++) {
+        FUZZ_CHECK(visualizerMaySkip((unsigned char)input[cursor]), "输入末尾有未识别的Token");
+    }
+
+    return 0;
+}
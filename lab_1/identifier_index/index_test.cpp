@@ -0,0 +1,181 @@
+// 标识符索引测试程序
+// 测试索引与词法分析结果一致、三种分析模式建立的索引相同，
+// 分片建立再合并的索引与一次建立的索引逐字节相同，以及损坏的索引文件被拒绝
+
+#include "../LexAnalysis.h"
+#include "../../common/test_util.h"
+
+/* 测试用的源程序 */
+const char* sources[] = {
+    "int main() {\n    int count = 0;\n    while (count < 10) count++;\n    return count;\n}\n",
+    "/* count不是标识符 */ int total; char* s = \"count total\";\nvoid f(int count) { total += count; }\n",
+    "",
+    "x y x\n\xe5\x8f\x98\xe9\x87\x8f = x;\n",
+    "int count, total, x;\n"
+};
+const size_t sourceCount = sizeof(sources) / sizeof(sources[0]);
+
+/* 直接由analyze()的结果得到标识符的全部出现位置，作为期望值 */
+map<string, vector<pair<uint32_t, uint64_t> > > expectedOccurrences() {
+    map<string, vector<pair<uint32_t, uint64_t> > > result;
+    for (size_t i = 0; i < sourceCount; i++) {
+        LexicalAnalyzer analyzer(sources[i], strlen(sources[i]));
+        analyzer.analyze();
+        const vector<Token>& tokens = analyzer.getTokens();
+        // 字符串内容也以81输出，只有位于一对引号之间的才不是标识符
+        bool inString = false;
+        for (size_t t = 0; t < tokens.size(); t++) {
+            if (tokens[t].code == 78) inString = !inString;
+            else if (tokens[t].code == 81 && !inString) {
+                result[tokens[t].name].push_back(make_pair((uint32_t)i, (uint64_t)tokens[t].offset));
+            }
+        }
+    }
+    return result;
+}
+
+/* 按给定方式建立源程序[from, to)的索引，mode: 0为analyze()，1为nextToken()，2为逐字节推送 */
+bool buildIndex(const string& path, size_t from, size_t to, int mode) {
+    IdentifierIndexBuilder builder;
+    for (size_t i = from; i < to; i++) {
+        uint32_t file = builder.addFile("file" + to_string(i));
+        if (mode == 0) {
+            LexicalAnalyzer analyzer(sources[i], strlen(sources[i]));
+            analyzer.setIndex(&builder, file);
+            analyzer.analyze();
+        } else if (mode == 1) {
+            LexicalAnalyzer analyzer(sources[i], strlen(sources[i]));
+            analyzer.setIndex(&builder, file);
+            while (analyzer.nextToken() != nullptr) {
+            }
+        } else {
+            LexicalAnalyzer analyzer;
+            analyzer.setIndex(&builder, file);
+            for (size_t c = 0; sources[i][c] != '\0'; c++) analyzer.feed(sources[i] + c, 1);
+            analyzer.finish();
+        }
+    }
+    return builder.write(path);
+}
+
+void testVarint() {
+    cout << "\n=== 变长整数编码 ===" << endl;
+    uint64_t values[] = {0, 1, 127, 128, 300, 16383, 16384, 0xffffffffULL, 0xffffffffffffffffULL};
+    bool ok = true;
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+        string encoded;
+        putVarint(encoded, values[i]);
+        const unsigned char* p = (const unsigned char*)encoded.data();
+        uint64_t decoded;
+        ok = ok && getVarint(p, p + encoded.size(), decoded) && decoded == values[i] &&
+             p == (const unsigned char*)encoded.data() + encoded.size();
+    }
+    check(ok, "编码后解码得到原值");
+    string truncated;
+    putVarint(truncated, 300);
+    const unsigned char* p = (const unsigned char*)truncated.data();
+    uint64_t v;
+    check(!getVarint(p, p + 1, v), "截断的编码被拒绝");
+}
+
+void testMatchesTokens() {
+    cout << "\n=== 索引与词法分析结果一致 ===" << endl;
+    check(buildIndex("all.lexidx", 0, sourceCount, 0), "建立索引");
+    IdentifierIndexReader reader;
+    check(reader.open("all.lexidx"), "打开索引");
+
+    map<string, vector<pair<uint32_t, uint64_t> > > expected = expectedOccurrences();
+    check(reader.symbolCount() == expected.size(), "标识符个数相同");
+    bool same = true;
+    vector<IdentifierOccurrence> found;
+    for (map<string, vector<pair<uint32_t, uint64_t> > >::iterator it = expected.begin();
+         it != expected.end(); ++it) {
+        long symbol = reader.findSymbol(it->first);
+        if (symbol < 0 || !reader.occurrences((uint32_t)symbol, found) ||
+            found.size() != it->second.size()) {
+            same = false;
+            continue;
+        }
+        for (size_t i = 0; i < found.size(); i++) {
+            same = same && found[i].file == it->second[i].first && found[i].offset == it->second[i].second;
+        }
+    }
+    check(same, "每个标识符的出现位置相同");
+    check(reader.findSymbol("main") >= 0 && reader.findSymbol("变量") >= 0, "ASCII与UTF-8标识符都可查到");
+    check(reader.findSymbol("int") < 0 && reader.findSymbol("coun") < 0 && reader.findSymbol("") < 0,
+          "关键字和不存在的名称查不到");
+    check(expected["count"].size() == 7, "注释和字符串中的名称不计入");
+    check(reader.fileName(1) == "file1", "文件表");
+}
+
+void testModes() {
+    cout << "\n=== 三种分析模式 ===" << endl;
+    buildIndex("incremental.lexidx", 0, sourceCount, 1);
+    buildIndex("push.lexidx", 0, sourceCount, 2);
+    string all = readFile("all.lexidx");
+    check(readFile("incremental.lexidx") == all, "nextToken()建立的索引与analyze()相同");
+    check(readFile("push.lexidx") == all, "逐字节推送建立的索引与analyze()相同（撤销的Token不会重复记录）");
+}
+
+void testMerge() {
+    cout << "\n=== 分片合并 ===" << endl;
+    buildIndex("part0.lexidx", 0, 2, 0);
+    buildIndex("part1.lexidx", 2, 3, 0);
+    buildIndex("part2.lexidx", 3, sourceCount, 0);
+    vector<string> parts;
+    parts.push_back("part0.lexidx");
+    parts.push_back("part1.lexidx");
+    parts.push_back("part2.lexidx");
+    check(mergeIdentifierIndexes(parts, "merged.lexidx"), "合并三个分片");
+    check(readFile("merged.lexidx") == readFile("all.lexidx"), "合并结果与一次建立的索引逐字节相同");
+
+    vector<string> single(1, "all.lexidx");
+    check(mergeIdentifierIndexes(single, "copy.lexidx") &&
+          readFile("copy.lexidx") == readFile("all.lexidx"), "合并单个索引得到原索引");
+
+    vector<string> missing(1, "no_such.lexidx");
+    check(!mergeIdentifierIndexes(missing, "bad.lexidx"), "输入不存在时合并失败");
+}
+
+void testCorruption() {
+    cout << "\n=== 损坏的索引文件 ===" << endl;
+    string all = readFile("all.lexidx");
+    IdentifierIndexReader reader;
+
+    writeFile("broken.lexidx", all.substr(0, all.size() - 1));
+    check(!reader.open("broken.lexidx"), "截断的文件被拒绝");
+
+    string badMagic = all;
+    badMagic[0] = 'X';
+    writeFile("broken.lexidx", badMagic);
+    check(!reader.open("broken.lexidx"), "文件头错误被拒绝");
+
+    writeFile("broken.lexidx", "LXI1");
+    check(!reader.open("broken.lexidx"), "过短的文件被拒绝");
+
+    // 把第一个符号的倒排表长度改为超出文件范围
+    string badLength = all;
+    IdentifierIndexHeader header;
+    memcpy(&header, badLength.data(), sizeof(header));
+    IdentifierSymbolRecord record;
+    memcpy(&record, badLength.data() + header.symbolTable, sizeof(record));
+    record.postingLength = all.size();
+    memcpy(&badLength[header.symbolTable], &record, sizeof(record));
+    writeFile("broken.lexidx", badLength);
+    check(!reader.open("broken.lexidx"), "越界的倒排表被拒绝");
+}
+
+int main() {
+    testVarint();
+    testMatchesTokens();
+    testModes();
+    testMerge();
+    testCorruption();
+
+    const char* files[] = {"all", "incremental", "push", "part0", "part1", "part2", "merged", "copy", "broken"};
+    for (size_t i = 0; i < sizeof(files) / sizeof(files[0]); i++) {
+        remove((string(files[i]) + ".lexidx").c_str());
+    }
+
+    return testSummary();
+}
@@ -0,0 +1,133 @@
+// 标识符索引工具
+// 用法：
+//   ./index_tool build 索引文件 源文件...       词法分析源文件，同时建立标识符索引
+//   ./index_tool merge 索引文件 分片索引...     按顺序合并分批建立的索引
+//   ./index_tool query 索引文件 标识符...       输出标识符的全部出现位置（文件:行:列）
+//   ./index_tool stats 索引文件                 输出索引的统计信息
+
+#include "../LexAnalysis.h"
+#include <fstream>
+#include <sstream>
+
+/* 读取整个文件，失败时返回false */
+bool readFile(const string& path, string& content) {
+    ifstream in(path.c_str(), ios::binary);
+    if (!in) return false;
+    stringstream ss;
+    ss << in.rdbuf();
+    content = ss.str();
+    return true;
+}
+
+/* 把偏移换算为行号和列号（从1开始），源文件不可读时返回false */
+bool lineAndColumn(const string& content, uint64_t offset, size_t& line, size_t& column) {
+    if (offset > content.size()) return false;
+    line = 1 + count(content.begin(), content.begin() + offset, '\n');
+    size_t lineStart = content.rfind('\n', offset == 0 ? string::npos : offset - 1);
+    column = (lineStart == string::npos || offset == 0) ? offset + 1 : offset - lineStart;
+    return true;
+}
+
+int build(const string& output, const vector<string>& sources) {
+    IdentifierIndexBuilder builder;
+    size_t tokenCount = 0;
+    for (size_t i = 0; i < sources.size(); i++) {
+        string content;
+        if (!readFile(sources[i], content)) {
+            cerr << "无法读取: " << sources[i] << endl;
+            return 1;
+        }
+        LexicalAnalyzer analyzer(content.data(), content.size());
+        analyzer.setIndex(&builder, builder.addFile(sources[i]));
+        analyzer.analyze();
+        tokenCount += analyzer.getTokens().size();
+    }
+    if (!builder.write(output)) {
+        cerr << "无法写入: " << output << endl;
+        return 1;
+    }
+    cout << sources.size() << " 个文件, " << tokenCount << " 个Token, "
+         << builder.symbolCount() << " 个标识符" << endl;
+    return 0;
+}
+
+int merge(const string& output, const vector<string>& inputs) {
+    if (!mergeIdentifierIndexes(inputs, output)) {
+        cerr << "合并失败（索引无法读取或已损坏）" << endl;
+        return 1;
+    }
+    return 0;
+}
+
+int query(const string& path, const vector<string>& names) {
+    IdentifierIndexReader reader;
+    if (!reader.open(path)) {
+        cerr << "无法打开索引: " << path << endl;
+        return 1;
+    }
+    vector<IdentifierOccurrence> found;
+    for (size_t n = 0; n < names.size(); n++) {
+        long symbol = reader.findSymbol(names[n]);
+        if (symbol < 0) {
+            cout << names[n] << ": 未找到" << endl;
+            continue;
+        }
+        if (!reader.occurrences((uint32_t)symbol, found)) {
+            cerr << "倒排表已损坏: " << names[n] << endl;
+            return 1;
+        }
+        cout << names[n] << ": " << found.size() << " 处" << endl;
+        // 同一文件的出现位置是连续的，每个文件只读取一次来换算行列号
+        string content;
+        bool readable = false;
+        for (size_t i = 0; i < found.size(); i++) {
+            string file = reader.fileName(found[i].file);
+            if (i == 0 || found[i].file != found[i - 1].file) {
+                readable = readFile(file, content);
+            }
+            size_t line, column;
+            if (readable && lineAndColumn(content, found[i].offset, line, column)) {
+                cout << "  " << file << ":" << line << ":" << column << endl;
+            } else {
+                cout << "  " << file << " @" << found[i].offset << endl;
+            }
+        }
+    }
+    return 0;
+}
+
+int stats(const string& path) {
+    IdentifierIndexReader reader;
+    if (!reader.open(path)) {
+        cerr << "无法打开索引: " << path << endl;
+        return 1;
+    }
+    uint64_t occurrences = 0, postingBytes = 0;
+    for (uint32_t i = 0; i < reader.symbolCount(); i++) {
+        occurrences += reader.symbol(i).count;
+        postingBytes += reader.symbol(i).postingLength;
+    }
+    cout << "文件数: " << reader.fileCount() << endl;
+    cout << "标识符数: " << reader.symbolCount() << endl;
+    cout << "出现次数: " << occurrences << endl;
+    cout << "倒排表字节数: " << postingBytes;
+    if (occurrences > 0) cout << "（平均每次出现 " << (double)postingBytes / occurrences << " 字节）";
+    cout << endl;
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        cerr << "用法: " << argv[0] << " build|merge|query|stats 索引文件 [参数...]" << endl;
+        return 2;
+    }
+    string command = argv[1];
+    string index = argv[2];
+    vector<string> args(argv + 3, argv + argc);
+    if (command == "build" && !args.empty()) return build(index, args);
+    if (command == "merge" && !args.empty()) return merge(index, args);
+    if (command == "query" && !args.empty()) return query(index, args);
+    if (command == "stats" && args.empty()) return stats(index);
+    cerr << "用法: " << argv[0] << " build|merge|query|stats 索引文件 [参数...]" << endl;
+    return 2;
+}
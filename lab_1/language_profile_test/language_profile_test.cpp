@@ -0,0 +1,137 @@
+// 语言配置测试程序
+// 测试SubsetProfile（实验二~四的子集文法）的词法分析结果，
+// 以及未启用的特性确实被裁剪掉；最后对比两种配置的分析速度
+
+#include "../LexAnalysis.h"
+#include <chrono>
+
+/* 把Token序列拼成"名称,编号 名称,编号 ..."，便于与期望值比较 */
+template <class Analyzer>
+string describeTokens(const string& input) {
+    Analyzer analyzer(input);
+    analyzer.analyze();
+    const vector<Token>& tokens = analyzer.getTokens();
+    string result;
+    for (size_t i = 0; i < tokens.size(); i++) {
+        if (i > 0) result += " ";
+        result += tokens[i].name + "," + to_string(tokens[i].code);
+    }
+    return result;
+}
+
+/* 对同一输入重复分析，返回最短耗时（毫秒） */
+template <class Analyzer>
+double measure(const string& input) {
+    double best = -1;
+    for (int r = 0; r < 5; r++) {
+        Analyzer analyzer(input.data(), input.size());
+        auto start = chrono::steady_clock::now();
+        analyzer.analyze();
+        auto end = chrono::steady_clock::now();
+        double ms = chrono::duration<double, milli>(end - start).count();
+        if (best < 0 || ms < best) best = ms;
+    }
+    return best;
+}
+
+int main() {
+    cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << endl;
+    cout << "语言配置测试程序" << endl;
+    cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << endl;
+    cout << endl;
+
+    struct TestCase {
+        string input;
+        string expected;
+        string description;
+    };
+
+    vector<TestCase> subsetTests = {
+        {"{ while ( ID == NUM ) { ID = NUM ; } }",
+         "{,59 while,32 (,44 ID,81 ==,73 NUM,81 ),45 {,59 ID,81 =,72 NUM,81 ;,53 },63 },63",
+         "实验二/三的while语句"},
+        {"int a = 1 ; real b = 2.5 ;",
+         "int,17 a,81 =,72 1,80 ;,53 real,83 b,81 =,72 2.5,80 ;,53",
+         "实验四的声明，real编号为83"},
+        {"if ( a <= b ) then a = a * 3 ; else b = b / 1.5 ;",
+         "if,16 (,44 a,81 <=,71 b,81 ),45 then,82 a,81 =,72 a,81 *,46 3,80 ;,53 else,10 b,81 =,72 b,81 /,50 1.5,80 ;,53",
+         "实验四的if语句，then编号为82"},
+        {"a>=b-c+d<e>f",
+         "a,81 >=,75 b,81 -,33 c,81 +,65 d,81 <,68 e,81 >,74 f,81",
+         "紧邻的运算符"},
+        {"a /* b */ c // d",
+         "a,81 /,50 *,46 b,81 *,46 /,50 c,81 /,50 /,50 d,81",
+         "没有注释：/和*按运算符识别"},
+        {"x = \"s\" ;",
+         "x,81 =,72 s,81 ;,53",
+         "没有字符串：引号被跳过"},
+        {"1e5 10L",
+         "1,80 e5,81 10,80 L,81",
+         "没有指数和后缀"},
+        {"x<<=2 && y->z != w",
+         "x,81 <,68 <=,71 2,80 y,81 -,33 >,74 z,81 =,72 w,81",
+         "C专有运算符被拆开（<<=拆为<和<=）或跳过"},
+        {"for return 变量",
+         "for,81 return,81",
+         "C关键字按标识符识别，不识别UTF-8标识符"},
+    };
+
+    int total = 0, passed = 0;
+
+    cout << "测试组 1: SubsetProfile" << endl;
+    cout << "─────────────────────────────────────" << endl;
+    for (const auto& test : subsetTests) {
+        total++;
+        string actual = describeTokens<SubsetLexicalAnalyzer>(test.input);
+        bool ok = actual == test.expected;
+        if (ok) passed++;
+        cout << "  " << test.description << ": " << (ok ? "✓" : "✗") << endl;
+        if (!ok) {
+            cout << "    输入: " << test.input << endl;
+            cout << "    期望: " << test.expected << endl;
+            cout << "    实际: " << actual << endl;
+        }
+    }
+    cout << endl;
+
+    cout << "测试组 2: CProfile保持原有行为" << endl;
+    cout << "─────────────────────────────────────" << endl;
+    vector<TestCase> cTests = {
+        {"a /* b */ c", "a,81 /* b */,79 c,81", "块注释"},
+        {"x<<=2", "x,81 <<=,70 2,80", "三字符运算符"},
+        {"then real", "then,81 real,81", "then、real不是C关键字"},
+    };
+    for (const auto& test : cTests) {
+        total++;
+        string actual = describeTokens<LexicalAnalyzer>(test.input);
+        bool ok = actual == test.expected;
+        if (ok) passed++;
+        cout << "  " << test.description << ": " << (ok ? "✓" : "✗") << endl;
+        if (!ok) {
+            cout << "    期望: " << test.expected << endl;
+            cout << "    实际: " << actual << endl;
+        }
+    }
+    cout << endl;
+
+    // 速度对比：同一段子集文法程序分别用两种配置分析
+    cout << "测试组 3: 速度对比（子集文法程序，约8MB）" << endl;
+    cout << "─────────────────────────────────────" << endl;
+    string program;
+    while (program.size() < 8 * 1024 * 1024) {
+        program += "{\n  while ( count <= limit ) {\n    total = total + count * 2.5 ;\n"
+                   "    if ( total >= 100 ) then count = count - 1 ; else count = count + 1 ;\n  }\n}\n";
+    }
+    double cMs = measure<LexicalAnalyzer>(program);
+    double subsetMs = measure<SubsetLexicalAnalyzer>(program);
+    cout << "  CProfile:      " << cMs << " 毫秒" << endl;
+    cout << "  SubsetProfile: " << subsetMs << " 毫秒" << endl;
+    cout << "  加速比: " << cMs / subsetMs << "x" << endl;
+    cout << endl;
+
+    cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << endl;
+    cout << "测试完成: " << passed << "/" << total << " 通过" << endl;
+    cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << endl;
+
+    return passed == total ? 0 : 1;
+}
@@ -0,0 +1,40 @@
+/* C接口测试程序
+ * 从标准输入读入源程序，通过C接口分批取出Token，按Analysis()相同的格式输出，
+ * 便于和test_automation的期望输出直接比对 */
+#include "lexer_api.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BATCH 16  /* 故意取较小的批量，覆盖多次调用的情形 */
+
+int main(void) {
+    size_t cap = 4096, len = 0;
+    char* buf = (char*)malloc(cap);
+    size_t n;
+    while (buf != NULL && (n = fread(buf + len, 1, cap - len, stdin)) > 0) {
+        len += n;
+        if (len == cap) {
+            cap *= 2;
+            buf = (char*)realloc(buf, cap);
+        }
+    }
+    if (buf == NULL || lexer_api_version() != LEXER_API_VERSION) {
+        fprintf(stderr, "初始化失败\n");
+        return 1;
+    }
+
+    lexer_handle* lexer = lexer_create(buf, len);
+    lexer_token tokens[BATCH];
+    long count, index = 0, i;
+    while ((count = lexer_next_tokens(lexer, tokens, BATCH)) > 0) {
+        for (i = 0; i < count; i++) {
+            /* 注意：最后一行后面不能有回车，因此换行输出在下一个Token之前 */
+            if (index > 0) putchar('\n');
+            printf("%ld: <%.*s,%d>", ++index, (int)tokens[i].length,
+                   buf + tokens[i].offset, tokens[i].code);
+        }
+    }
+    lexer_destroy(lexer);
+    free(buf);
+    return count < 0 ? 1 : 0;
+}
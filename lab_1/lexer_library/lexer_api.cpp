@@ -0,0 +1,48 @@
+// 词法分析器C语言接口实现
+// 对LexicalAnalyzer的增量模式做一层薄封装，C++异常不会越过C接口边界
+#include "lexer_api.h"
+#include "../LexAnalysis.h"
+#include <new>
+
+/* 句柄即分析器本身，C侧只看到不透明指针 */
+struct lexer_handle {
+    LexicalAnalyzer analyzer;
+
+    lexer_handle(const char* source, size_t length) : analyzer(source, length) {}
+};
+
+int lexer_api_version(void) {
+    return LEXER_API_VERSION;
+}
+
+lexer_handle* lexer_create(const char* source, size_t length) {
+    if (source == NULL && length != 0) return NULL;
+    try {
+        return new lexer_handle(source == NULL ? "" : source, length);
+    } catch (...) {
+        return NULL;
+    }
+}
+
+long lexer_next_tokens(lexer_handle* lexer, lexer_token* out, size_t capacity) {
+    if (lexer == NULL || (out == NULL && capacity != 0)) return -1;
+    try {
+        long count = 0;
+        while ((size_t)count < capacity) {
+            const Token* t = lexer->analyzer.nextToken();
+            if (t == nullptr) break;
+            out[count].offset = t->offset;
+            out[count].length = t->name.size();
+            out[count].code = t->code;
+            out[count].line = t->line;
+            count++;
+        }
+        return count;
+    } catch (...) {
+        return -1;
+    }
+}
+
+void lexer_destroy(lexer_handle* lexer) {
+    delete lexer;
+}
@@ -0,0 +1,53 @@
+/* 词法分析器C语言接口
+ * 以静态库/动态库形式嵌入其他程序（Python ctypes、Go cgo等），进程内直接调用，
+ * 无需为每次分析启动子进程。所有状态保存在句柄中，没有全局可变状态，
+ * 不同句柄可以在不同线程中并发使用。
+ */
+#ifndef LEXER_API_H
+#define LEXER_API_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(_WIN32)
+#define LEXER_API __declspec(dllexport)
+#else
+#define LEXER_API __attribute__((visibility("default")))
+#endif
+
+/* 接口版本号，结构体布局或函数语义发生不兼容变化时递增 */
+#define LEXER_API_VERSION 1
+
+/* 不透明的分析器句柄 */
+typedef struct lexer_handle lexer_handle;
+
+/* 一个词法单元，内容为调用方缓冲区中的[offset, offset + length)，不另行复制 */
+typedef struct lexer_token {
+    size_t offset;   /* 起始字节偏移 */
+    size_t length;   /* 字节长度 */
+    int code;        /* 符号编号，与Analysis()的输出一致 */
+    int line;        /* 起始行号，从1开始 */
+} lexer_token;
+
+/* 返回库实现的接口版本号，调用方应检查其等于LEXER_API_VERSION */
+LEXER_API int lexer_api_version(void);
+
+/* 在调用方持有的缓冲区上创建分析器，缓冲区在lexer_destroy之前必须保持有效
+ * 内存不足时返回NULL */
+LEXER_API lexer_handle* lexer_create(const char* source, size_t length);
+
+/* 将接下来至多capacity个Token写入out
+ * 返回写入的个数，返回0表示分析结束，参数非法或内存不足返回-1 */
+LEXER_API long lexer_next_tokens(lexer_handle* lexer, lexer_token* out, size_t capacity);
+
+/* 销毁分析器，lexer可以为NULL */
+LEXER_API void lexer_destroy(lexer_handle* lexer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
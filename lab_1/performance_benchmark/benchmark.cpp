@@ -1,47 +1,61 @@
 // 性能基准测试程序
-// 对比不同关键字查找方法的性能
+// 对比不同关键字查找方法的性能：每种方法在多种输入分布下重复测量，
+// 报告每次查找的纳秒数、95%置信区间和分支预测失败次数
 
-#include <iostream>
-#include <string>
+#include "../LexAnalysis.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
 #include <map>
+#include <random>
 #include <unordered_map>
 #include <vector>
-#include <chrono>
-#include <cstring>
-using namespace std;
+#include <dirent.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
-// 方法1：线性数组查找
+// 方法1：线性数组查找（本项目采用，与BasicLexicalAnalyzer::keywordCode相同）
+// 先查首字符表排除不可能是关键字的词，再在语言配置的关键字数组中顺序查找，逐字节比较
 class LinearSearchAnalyzer {
-private:
-    struct KeywordPair {
-        const char* keyword;
-        int code;
-    };
-
-    static const KeywordPair keywords[];
-
+    bool starts[256];  // starts[c]表示有关键字以c开头
 public:
+    LinearSearchAnalyzer() : starts() {
+        const ProfileKeyword* list = CProfile::keywords();
+        for (int i = 0; i < CProfile::keywordCount; i++) {
+            starts[(unsigned char)list[i].word[0]] = true;
+        }
+    }
+
     int findKeyword(const string& word) {
-        for (int i = 0; i < 32; i++) {
-            if (word == keywords[i].keyword) {
-                return keywords[i].code;
+        if (word.empty() || !starts[(unsigned char)word[0]]) return -1;
+        const char* w = word.data();
+        size_t len = word.size();
+        const ProfileKeyword* list = CProfile::keywords();
+        for (int i = 0; i < CProfile::keywordCount; i++) {
+            const char* k = list[i].word;
+            if (k[0] != w[0]) continue;
+            size_t j = 1;
+            while (j < len && k[j] == w[j]) {
+                j++;
+            }
+            if (j == len && k[len] == '\0') {
+                return list[i].code;
             }
         }
         return -1;  // 不是关键字
     }
 };
 
-const LinearSearchAnalyzer::KeywordPair LinearSearchAnalyzer::keywords[] = {
-    {"auto", 1}, {"break", 2}, {"case", 3}, {"char", 4},
-    {"const", 5}, {"continue", 6}, {"default", 7}, {"do", 8},
-    {"double", 9}, {"else", 10}, {"enum", 11}, {"extern", 12},
-    {"float", 13}, {"for", 14}, {"goto", 15}, {"if", 16},
-    {"int", 17}, {"long", 18}, {"register", 19}, {"return", 20},
-    {"short", 21}, {"signed", 22}, {"sizeof", 23}, {"static", 24},
-    {"struct", 25}, {"switch", 26}, {"typedef", 27}, {"union", 28},
-    {"unsigned", 29}, {"void", 30}, {"volatile", 31}, {"while", 32}
-};
-
 // 方法2：map（红黑树）查找
 class MapSearchAnalyzer {
 private:
@@ -142,13 +156,422 @@ public:
     }
 };
 
-int main() {
+// 方法4：完美哈希
+// 哈希函数只看长度、首字符和末字符，系数是离线搜索得到的，32个关键字落在64个槽中互不冲突；
+// 每次查找只需一次哈希和一次memcmp。槽位是否正确由下面的static_assert在编译期检查
+struct PerfectHashEntry {
+    const char* keyword;
+    unsigned char length;
+    int code;
+};
+
+constexpr unsigned perfectHash(const char* s, size_t len) {
+    return (unsigned)(len * 5 + (unsigned char)s[0] * 14 + (unsigned char)s[len - 1] * 5) & 63;
+}
+
+constexpr PerfectHashEntry perfectHashTable[64] = {
+    {"return", 6, 20}, {nullptr, 0, 0}, {"unsigned", 8, 29}, {nullptr, 0, 0},
+    {nullptr, 0, 0}, {nullptr, 0, 0}, {"if", 2, 16}, {"const", 5, 5},
+    {nullptr, 0, 0}, {nullptr, 0, 0}, {"extern", 6, 12}, {"continue", 8, 6},
+    {"break", 5, 2}, {"auto", 4, 1}, {nullptr, 0, 0}, {"double", 6, 9},
+    {nullptr, 0, 0}, {"int", 3, 17}, {nullptr, 0, 0}, {"else", 4, 10},
+    {"while", 5, 32}, {"volatile", 8, 31}, {nullptr, 0, 0}, {"static", 6, 24},
+    {nullptr, 0, 0}, {nullptr, 0, 0}, {nullptr, 0, 0}, {nullptr, 0, 0},
+    {"signed", 6, 22}, {"for", 3, 14}, {"register", 8, 19}, {"default", 7, 7},
+    {nullptr, 0, 0}, {"goto", 4, 15}, {nullptr, 0, 0}, {nullptr, 0, 0},
+    {nullptr, 0, 0}, {"union", 5, 28}, {"sizeof", 6, 23}, {"short", 5, 21},
+    {nullptr, 0, 0}, {nullptr, 0, 0}, {nullptr, 0, 0}, {nullptr, 0, 0},
+    {"struct", 6, 25}, {"do", 2, 8}, {nullptr, 0, 0}, {nullptr, 0, 0},
+    {"switch", 6, 26}, {"float", 5, 13}, {nullptr, 0, 0}, {nullptr, 0, 0},
+    {nullptr, 0, 0}, {nullptr, 0, 0}, {nullptr, 0, 0}, {"case", 4, 3},
+    {"char", 4, 4}, {"typedef", 7, 27}, {nullptr, 0, 0}, {"enum", 4, 11},
+    {"void", 4, 30}, {nullptr, 0, 0}, {nullptr, 0, 0}, {"long", 4, 18},
+};
+
+constexpr size_t constLength(const char* s) {
+    return *s ? 1 + constLength(s + 1) : 0;
+}
+
+/* 编译期检查：每个关键字的长度正确，且恰好位于自己的哈希槽中 */
+constexpr bool perfectHashSlotsValid(size_t i) {
+    return i == 64 ||
+           ((perfectHashTable[i].keyword == nullptr ||
+             (constLength(perfectHashTable[i].keyword) == perfectHashTable[i].length &&
+              perfectHash(perfectHashTable[i].keyword, perfectHashTable[i].length) == i)) &&
+            perfectHashSlotsValid(i + 1));
+}
+static_assert(perfectHashSlotsValid(0), "完美哈希表与哈希函数不一致");
+
+class PerfectHashSearchAnalyzer {
+public:
+    int findKeyword(const string& word) {
+        size_t len = word.size();
+        if (len < 2 || len > 8) return -1;
+        const PerfectHashEntry& e = perfectHashTable[perfectHash(word.data(), len)];
+        if (e.length == len && memcmp(e.keyword, word.data(), len) == 0) {
+            return e.code;
+        }
+        return -1;
+    }
+};
+
+// 方法5：按长度分桶的switch，桶内再按首字符分支，最后用定长memcmp确认
+class LengthSwitchSearchAnalyzer {
+public:
+    int findKeyword(const string& word) {
+        const char* s = word.data();
+        switch (word.size()) {
+        case 2:
+            if (memcmp(s, "do", 2) == 0) return 8;
+            if (memcmp(s, "if", 2) == 0) return 16;
+            return -1;
+        case 3:
+            if (memcmp(s, "for", 3) == 0) return 14;
+            if (memcmp(s, "int", 3) == 0) return 17;
+            return -1;
+        case 4:
+            switch (s[0]) {
+            case 'a':
+                if (memcmp(s, "auto", 4) == 0) return 1;
+                return -1;
+            case 'c':
+                if (memcmp(s, "case", 4) == 0) return 3;
+                if (memcmp(s, "char", 4) == 0) return 4;
+                return -1;
+            case 'e':
+                if (memcmp(s, "else", 4) == 0) return 10;
+                if (memcmp(s, "enum", 4) == 0) return 11;
+                return -1;
+            case 'g':
+                if (memcmp(s, "goto", 4) == 0) return 15;
+                return -1;
+            case 'l':
+                if (memcmp(s, "long", 4) == 0) return 18;
+                return -1;
+            case 'v':
+                if (memcmp(s, "void", 4) == 0) return 30;
+                return -1;
+            default:
+                return -1;
+            }
+        case 5:
+            switch (s[0]) {
+            case 'b':
+                if (memcmp(s, "break", 5) == 0) return 2;
+                return -1;
+            case 'c':
+                if (memcmp(s, "const", 5) == 0) return 5;
+                return -1;
+            case 'f':
+                if (memcmp(s, "float", 5) == 0) return 13;
+                return -1;
+            case 's':
+                if (memcmp(s, "short", 5) == 0) return 21;
+                return -1;
+            case 'u':
+                if (memcmp(s, "union", 5) == 0) return 28;
+                return -1;
+            case 'w':
+                if (memcmp(s, "while", 5) == 0) return 32;
+                return -1;
+            default:
+                return -1;
+            }
+        case 6:
+            switch (s[0]) {
+            case 'd':
+                if (memcmp(s, "double", 6) == 0) return 9;
+                return -1;
+            case 'e':
+                if (memcmp(s, "extern", 6) == 0) return 12;
+                return -1;
+            case 'r':
+                if (memcmp(s, "return", 6) == 0) return 20;
+                return -1;
+            case 's':
+                if (memcmp(s, "signed", 6) == 0) return 22;
+                if (memcmp(s, "sizeof", 6) == 0) return 23;
+                if (memcmp(s, "static", 6) == 0) return 24;
+                if (memcmp(s, "struct", 6) == 0) return 25;
+                if (memcmp(s, "switch", 6) == 0) return 26;
+                return -1;
+            default:
+                return -1;
+            }
+        case 7:
+            if (memcmp(s, "default", 7) == 0) return 7;
+            if (memcmp(s, "typedef", 7) == 0) return 27;
+            return -1;
+        case 8:
+            switch (s[0]) {
+            case 'c':
+                if (memcmp(s, "continue", 8) == 0) return 6;
+                return -1;
+            case 'r':
+                if (memcmp(s, "register", 8) == 0) return 19;
+                return -1;
+            case 'u':
+                if (memcmp(s, "unsigned", 8) == 0) return 29;
+                return -1;
+            case 'v':
+                if (memcmp(s, "volatile", 8) == 0) return 31;
+                return -1;
+            default:
+                return -1;
+            }
+        default:
+            return -1;
+        }
+    }
+};
+
+// 方法6：字节trie，关键字只含小写字母，每个结点26个子结点，出现其他字符立即失败
+class TrieSearchAnalyzer {
+private:
+    vector<int16_t> children;  // 结点i的子结点位于[i * 26, i * 26 + 26)，0表示没有
+    vector<int> codes;         // 结点对应的关键字编号，-1表示不是关键字
+
+    int addNode() {
+        children.resize(children.size() + 26, 0);
+        codes.push_back(-1);
+        return (int)codes.size() - 1;
+    }
+
+public:
+    TrieSearchAnalyzer() {
+        addNode();  // 根结点
+        for (int i = 0; i < 64; i++) {
+            const PerfectHashEntry& e = perfectHashTable[i];
+            if (e.keyword == nullptr) continue;
+            int node = 0;
+            for (const char* p = e.keyword; *p; p++) {
+                int c = *p - 'a';
+                if (children[node * 26 + c] == 0) {
+                    int child = addNode();
+                    children[node * 26 + c] = (int16_t)child;
+                }
+                node = children[node * 26 + c];
+            }
+            codes[node] = e.code;
+        }
+    }
+
+    int findKeyword(const string& word) {
+        int node = 0;
+        for (size_t i = 0; i < word.size(); i++) {
+            unsigned c = (unsigned char)word[i] - 'a';
+            if (c >= 26) return -1;
+            node = children[node * 26 + c];
+            if (node == 0) return -1;
+        }
+        return codes[node];
+    }
+};
+
+// 方法7：SIMD整词比较
+// 关键字按长度分组并补零到16字节；查找时把单词同样补零到16字节，与同长度的候选逐个做
+// 一次16字节比较（SSE2的pcmpeqb + pmovmskb），不支持SSE2时退化为16字节memcmp
+class SimdSearchAnalyzer {
+private:
+    struct alignas(16) PaddedKeyword {
+        char bytes[16];
+        int code;
+    };
+    vector<PaddedKeyword> byLength[9];  // 关键字长度为2~8
+
+public:
+    SimdSearchAnalyzer() {
+        for (int i = 0; i < 64; i++) {
+            const PerfectHashEntry& e = perfectHashTable[i];
+            if (e.keyword == nullptr) continue;
+            PaddedKeyword k;
+            memset(k.bytes, 0, sizeof(k.bytes));
+            memcpy(k.bytes, e.keyword, e.length);
+            k.code = e.code;
+            byLength[e.length].push_back(k);
+        }
+    }
+
+    int findKeyword(const string& word) {
+        size_t len = word.size();
+        if (len < 2 || len > 8) return -1;
+        alignas(16) char padded[16] = {0};
+        memcpy(padded, word.data(), len);
+        const vector<PaddedKeyword>& candidates = byLength[len];
+#if defined(__SSE2__)
+        __m128i w = _mm_load_si128((const __m128i*)padded);
+        for (size_t i = 0; i < candidates.size(); i++) {
+            __m128i k = _mm_load_si128((const __m128i*)candidates[i].bytes);
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(w, k)) == 0xFFFF) {
+                return candidates[i].code;
+            }
+        }
+#else
+        for (size_t i = 0; i < candidates.size(); i++) {
+            if (memcmp(padded, candidates[i].bytes, 16) == 0) {
+                return candidates[i].code;
+            }
+        }
+#endif
+        return -1;
+    }
+};
+
+/* 分支预测失败计数器，基于Linux的perf_event_open；不可用时（非Linux、容器禁用等）只报告时间 */
+class BranchMissCounter {
+private:
+    int fd;
+
+public:
+    BranchMissCounter() : fd(-1) {
+#if defined(__linux__)
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+    }
+
+    ~BranchMissCounter() {
+#if defined(__linux__)
+        if (fd >= 0) close(fd);
+#endif
+    }
+
+    bool available() const {
+        return fd >= 0;
+    }
+
+    void start() {
+#if defined(__linux__)
+        if (fd < 0) return;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+
+    uint64_t stop() {
+        uint64_t count = 0;
+#if defined(__linux__)
+        if (fd < 0) return 0;
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(fd, &count, sizeof(count)) != (ssize_t)sizeof(count)) count = 0;
+#endif
+        return count;
+    }
+};
+
+/* 一种方法在一种分布下的测量结果 */
+struct BenchResult {
+    double meanNs;          // 每次查找的平均纳秒数
+    double ciNs;            // 95%置信区间的半宽
+    double missesPerLookup; // 每次查找的分支预测失败次数
+};
+
+const int trials = 15;        // 每种组合重复测量的次数
+const double tValue = 2.145;  // 自由度14的t分布97.5%分位数
+const int passes = 16;        // 每次测量遍历输入的次数
+volatile long long sink;      // 防止查找结果被优化掉
+
+/* 重复测量trials次，每次遍历words共passes遍，返回平均值和置信区间 */
+template <class Analyzer>
+BenchResult measure(Analyzer& analyzer, const vector<string>& words, BranchMissCounter& counter) {
+    long long sum = 0;
+    for (size_t i = 0; i < words.size(); i++) {
+        sum += analyzer.findKeyword(words[i]);  // 预热
+    }
+
+    double lookups = (double)words.size() * passes;
+    vector<double> samples;
+    uint64_t misses = 0;
+    for (int t = 0; t < trials; t++) {
+        counter.start();
+        auto start = chrono::steady_clock::now();
+        for (int p = 0; p < passes; p++) {
+            for (size_t i = 0; i < words.size(); i++) {
+                sum += analyzer.findKeyword(words[i]);
+            }
+        }
+        auto end = chrono::steady_clock::now();
+        misses += counter.stop();
+        samples.push_back(chrono::duration<double, nano>(end - start).count() / lookups);
+    }
+    sink = sum;
+
+    double mean = 0;
+    for (size_t i = 0; i < samples.size(); i++) mean += samples[i];
+    mean /= samples.size();
+    double var = 0;
+    for (size_t i = 0; i < samples.size(); i++) var += (samples[i] - mean) * (samples[i] - mean);
+    double sd = sqrt(var / (samples.size() - 1));
+
+    BenchResult r;
+    r.meanNs = mean;
+    r.ciNs = tValue * sd / sqrt((double)samples.size());
+    r.missesPerLookup = misses / (lookups * trials);
+    return r;
+}
+
+/* 一种输入分布 */
+struct Distribution {
+    string name;
+    vector<string> words;
+};
+
+/* 判断是否为ASCII标识符（过滤字符串内容等） */
+bool isPlainIdentifier(const string& s) {
+    if (s.empty() || isdigit((unsigned char)s[0])) return false;
+    for (size_t i = 0; i < s.size(); i++) {
+        if (!isalnum((unsigned char)s[i]) && s[i] != '_') return false;
+    }
+    return true;
+}
+
+/* 用本项目的词法分析器扫描C源文件，按出现顺序收集关键字和标识符 */
+void collectCorpusWords(const string& path, vector<string>& words) {
+    ifstream in(path.c_str(), ios::binary);
+    if (!in) {
+        cerr << "无法读取: " << path << endl;
+        return;
+    }
+    stringstream ss;
+    ss << in.rdbuf();
+    string source = ss.str();
+
+    LexicalAnalyzer analyzer(source);
+    analyzer.analyze();
+    const vector<Token>& tokens = analyzer.getTokens();
+    bool inString = false;
+    for (size_t i = 0; i < tokens.size(); i++) {
+        if (tokens[i].code == 78 && tokens[i].name == "\"") {
+            inString = !inString;
+        } else if (!inString && (tokens[i].code <= 32 || tokens[i].code == 81) &&
+                   isPlainIdentifier(tokens[i].name)) {
+            words.push_back(tokens[i].name);
+        }
+    }
+}
+
+/* 把单词序列循环铺满到n个 */
+vector<string> tile(const vector<string>& words, size_t n) {
+    vector<string> result;
+    result.reserve(n);
+    for (size_t i = 0; i < n; i++) result.push_back(words[i % words.size()]);
+    return result;
+}
+
+int main(int argc, char* argv[]) {
     cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << endl;
     cout << "关键字查找性能基准测试" << endl;
     cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << endl;
     cout << endl;
 
-    // 测试数据
+    // 原始测试数据
     vector<string> testWords = {
         "int", "main", "return", "if", "else", "while", "for",
         "auto", "break", "case", "char", "const", "continue",
@@ -156,82 +579,124 @@ int main() {
         "myVar", "counter", "index", "temp", "result"
     };
 
-    const int iterations = 100000;  // 迭代次数
-
-    // 测试方法1：线性查找
-    LinearSearchAnalyzer linear;
-    auto start1 = chrono::high_resolution_clock::now();
-    for (int i = 0; i < iterations; i++) {
-        for (const auto& word : testWords) {
-            linear.findKeyword(word);
+    // 语料：命令行给出的C源文件，默认使用自动化测试的用例
+    vector<string> corpusFiles;
+    for (int i = 1; i < argc; i++) corpusFiles.push_back(argv[i]);
+    if (corpusFiles.empty()) {
+        const string dir = "../test_automation/test_cases";
+        if (DIR* d = opendir(dir.c_str())) {
+            while (struct dirent* e = readdir(d)) {
+                string name = e->d_name;
+                if (name.size() > 2 && name.compare(name.size() - 2, 2, ".c") == 0) {
+                    corpusFiles.push_back(dir + "/" + name);
+                }
+            }
+            closedir(d);
+            sort(corpusFiles.begin(), corpusFiles.end());
         }
     }
-    auto end1 = chrono::high_resolution_clock::now();
-    auto duration1 = chrono::duration_cast<chrono::microseconds>(end1 - start1).count();
+    vector<string> corpusWords;
+    for (size_t i = 0; i < corpusFiles.size(); i++) {
+        collectCorpusWords(corpusFiles[i], corpusWords);
+    }
 
-    // 测试方法2：map查找
-    MapSearchAnalyzer mapSearch;
-    auto start2 = chrono::high_resolution_clock::now();
-    for (int i = 0; i < iterations; i++) {
-        for (const auto& word : testWords) {
-            mapSearch.findKeyword(word);
-        }
+    // 每种分布铺满到65536个词：足以让分支预测器无法记住整个序列，又能留在缓存中
+    const size_t distributionSize = 65536;
+    vector<Distribution> distributions;
+    Distribution original = {"原始测试词（22个词循环）", tile(testWords, distributionSize)};
+    distributions.push_back(original);
+    if (!corpusWords.empty()) {
+        Distribution ordered = {"语料顺序（按源程序中的出现顺序）", tile(corpusWords, distributionSize)};
+        distributions.push_back(ordered);
+        Distribution shuffled = {"语料打乱（同样的词频，随机顺序）", ordered.words};
+        mt19937 rng(12345);
+        shuffle(shuffled.words.begin(), shuffled.words.end(), rng);
+        distributions.push_back(shuffled);
     }
-    auto end2 = chrono::high_resolution_clock::now();
-    auto duration2 = chrono::duration_cast<chrono::microseconds>(end2 - start2).count();
 
-    // 测试方法3：unordered_map查找
+    LinearSearchAnalyzer linear;
+    MapSearchAnalyzer mapSearch;
     HashMapSearchAnalyzer hashSearch;
-    auto start3 = chrono::high_resolution_clock::now();
-    for (int i = 0; i < iterations; i++) {
-        for (const auto& word : testWords) {
-            hashSearch.findKeyword(word);
+    PerfectHashSearchAnalyzer perfectHash;
+    LengthSwitchSearchAnalyzer lengthSwitch;
+    TrieSearchAnalyzer trie;
+    SimdSearchAnalyzer simd;
+
+    // 正确性检查：所有方法对所有输入的结果必须与map一致
+    for (size_t d = 0; d < distributions.size(); d++) {
+        const vector<string>& words = distributions[d].words;
+        for (size_t i = 0; i < words.size(); i++) {
+            int expected = mapSearch.findKeyword(words[i]);
+            if (linear.findKeyword(words[i]) != expected ||
+                hashSearch.findKeyword(words[i]) != expected ||
+                perfectHash.findKeyword(words[i]) != expected ||
+                lengthSwitch.findKeyword(words[i]) != expected ||
+                trie.findKeyword(words[i]) != expected ||
+                simd.findKeyword(words[i]) != expected) {
+                cout << "✗ 查找结果不一致: " << words[i] << endl;
+                return 1;
+            }
         }
     }
-    auto end3 = chrono::high_resolution_clock::now();
-    auto duration3 = chrono::duration_cast<chrono::microseconds>(end3 - start3).count();
 
-    // 输出结果
+    BranchMissCounter counter;
+
     cout << "测试配置：" << endl;
     cout << "  关键字数量: 32" << endl;
-    cout << "  测试词数量: " << testWords.size() << endl;
-    cout << "  迭代次数: " << iterations << endl;
-    cout << "  总查找次数: " << (iterations * testWords.size()) << endl;
+    cout << "  语料文件数: " << corpusFiles.size() << "，其中的关键字和标识符: " << corpusWords.size() << " 个" << endl;
+    cout << "  每种分布: " << distributionSize << " 个词，每次测量遍历 " << passes << " 遍" << endl;
+    cout << "  重复测量: " << trials << " 次，报告平均值和95%置信区间" << endl;
+    cout << "  分支预测失败计数: " << (counter.available() ? "perf_event" : "不可用（需要Linux perf_event权限）") << endl;
+    cout << "  所有方法的查找结果一致 ✓" << endl;
     cout << endl;
 
-    cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << endl;
-    cout << "性能测试结果" << endl;
-    cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << endl;
-    cout << endl;
+    cout << fixed << setprecision(2);
+    for (size_t d = 0; d < distributions.size(); d++) {
+        const vector<string>& words = distributions[d].words;
+        size_t keywordHits = 0;
+        for (size_t i = 0; i < words.size(); i++) {
+            if (mapSearch.findKeyword(words[i]) > 0) keywordHits++;
+        }
 
-    cout << "方法1: 线性数组查找" << endl;
-    cout << "  时间复杂度: O(n)" << endl;
-    cout << "  总耗时: " << duration1 << " 微秒" << endl;
-    cout << "  平均每次查找: " << (double)duration1 / (iterations * testWords.size()) << " 微秒" << endl;
-    cout << endl;
+        cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << endl;
+        cout << "分布: " << distributions[d].name << endl;
+        cout << "关键字占比: " << 100.0 * keywordHits / words.size() << "%" << endl;
+        cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << endl;
 
-    cout << "方法2: map（红黑树）查找 ★ 本项目采用" << endl;
-    cout << "  时间复杂度: O(log n)" << endl;
-    cout << "  总耗时: " << duration2 << " 微秒" << endl;
-    cout << "  平均每次查找: " << (double)duration2 / (iterations * testWords.size()) << " 微秒" << endl;
-    cout << "  相比线性查找: " << (double)duration1 / duration2 << "x 速度" << endl;
-    cout << endl;
+        struct Row {
+            string name;
+            BenchResult result;
+        };
+        vector<Row> rows;
+        Row r;
+        r.name = "方法1: 线性数组查找 ★ 本项目采用"; r.result = measure(linear, words, counter);       rows.push_back(r);
+        r.name = "方法2: map（红黑树）";             r.result = measure(mapSearch, words, counter);    rows.push_back(r);
+        r.name = "方法3: unordered_map（哈希表）";  r.result = measure(hashSearch, words, counter);   rows.push_back(r);
+        r.name = "方法4: 完美哈希";                 r.result = measure(perfectHash, words, counter);  rows.push_back(r);
+        r.name = "方法5: 按长度分桶的switch";       r.result = measure(lengthSwitch, words, counter); rows.push_back(r);
+        r.name = "方法6: 字节trie";                 r.result = measure(trie, words, counter);         rows.push_back(r);
+        r.name = "方法7: SIMD整词比较";             r.result = measure(simd, words, counter);         rows.push_back(r);
 
-    cout << "方法3: unordered_map（哈希表）查找" << endl;
-    cout << "  时间复杂度: O(1) 平均" << endl;
-    cout << "  总耗时: " << duration3 << " 微秒" << endl;
-    cout << "  平均每次查找: " << (double)duration3 / (iterations * testWords.size()) << " 微秒" << endl;
-    cout << "  相比线性查找: " << (double)duration1 / duration3 << "x 速度" << endl;
-    cout << endl;
+        size_t fastest = 0;
+        for (size_t i = 0; i < rows.size(); i++) {
+            cout << rows[i].name << endl;
+            cout << "  平均每次查找: " << rows[i].result.meanNs << " ± " << rows[i].result.ciNs << " 纳秒" << endl;
+            if (counter.available()) {
+                cout << "  分支预测失败: " << rows[i].result.missesPerLookup << " 次/查找" << endl;
+            }
+            cout << "  相比map: " << rows[1].result.meanNs / rows[i].result.meanNs << "x 速度" << endl;
+            if (rows[i].result.meanNs < rows[fastest].result.meanNs) fastest = i;
+        }
+        cout << "最快: " << rows[fastest].name << endl;
+        cout << endl;
+    }
 
     cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << endl;
     cout << "结论" << endl;
     cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << endl;
-    cout << "对于32个关键字的规模：" << endl;
-    cout << "- map（红黑树）提供了良好的性能和稳定性" << endl;
-    cout << "- 比线性查找快数倍" << endl;
-    cout << "- C++11标准兼容" << endl;
-    cout << "- 适合本项目的需求" << endl;
+    cout << "- 置信区间不重叠的两种方法才有显著差异" << endl;
+    cout << "- 语料顺序与语料打乱的差距来自分支预测：真实代码的词序有规律可循" << endl;
+    cout << "- 关键字占比低时，能尽早排除非关键字的方法（完美哈希、长度switch）优势更明显" << endl;
     cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << endl;
 
     return 0;
@@ -0,0 +1,143 @@
+// 推送模式测试程序
+// 测试feed()/finish()分段输入时，跨段的Token与一次性分析的结果完全相同，
+// 以及超长的跨段Token（如几十MB的块注释）不会导致反复重扫
+
+#include "../LexAnalysis.h"
+#include <chrono>
+
+/* 把Token序列拼成字符串，便于比较 */
+string describe(const vector<Token>& tokens) {
+    string result;
+    for (size_t i = 0; i < tokens.size(); i++) {
+        result += tokens[i].name + "," + to_string(tokens[i].code) + "@" +
+                  to_string(tokens[i].offset) + ":" + to_string(tokens[i].line) + "\n";
+    }
+    return result;
+}
+
+/* 按给定的分段大小推送输入，收集全部Token */
+vector<Token> pushInChunks(const string& input, size_t chunkSize) {
+    LexicalAnalyzer analyzer;
+    vector<Token> result;
+    for (size_t i = 0; i < input.size(); i += chunkSize) {
+        const vector<Token>& part = analyzer.feed(input.data() + i, min(chunkSize, input.size() - i));
+        result.insert(result.end(), part.begin(), part.end());
+    }
+    const vector<Token>& rest = analyzer.finish();
+    result.insert(result.end(), rest.begin(), rest.end());
+    return result;
+}
+
+/* 按给定位置切成两段推送 */
+vector<Token> pushInTwo(const string& input, size_t split) {
+    LexicalAnalyzer analyzer;
+    vector<Token> result = analyzer.feed(input.substr(0, split));
+    const vector<Token>& second = analyzer.feed(input.substr(split));
+    result.insert(result.end(), second.begin(), second.end());
+    const vector<Token>& rest = analyzer.finish();
+    result.insert(result.end(), rest.begin(), rest.end());
+    return result;
+}
+
+vector<Token> analyzeAll(const string& input) {
+    LexicalAnalyzer analyzer(input);
+    analyzer.analyze();
+    return analyzer.getTokens();
+}
+
+int main() {
+    cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << endl;
+    cout << "推送模式测试程序" << endl;
+    cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << endl;
+    cout << endl;
+
+    int total = 0, passed = 0;
+
+    // 测试组1：在每一个位置切成两段
+    cout << "测试组 1: 跨段Token（在每个位置切成两段）" << endl;
+    cout << "─────────────────────────────────────" << endl;
+    struct TestCase {
+        string input;
+        string description;
+    };
+    vector<TestCase> tests = {
+        {"counter = counter + 1;", "标识符"},
+        {"x <<= 2; y >>= 3; p->q != r;", "多字符运算符"},
+        {"a /* block\ncomment */ b // line\nc", "块注释与行注释"},
+        {"s = \"esc \\\" quote \\\\ and \\\nnewline\";", "字符串与转义"},
+        {"f = 3.14e+10; g = 1.; h = 5e; k = 10UL;", "数字的小数、指数与后缀"},
+        {"变量 = 中文标识符 + x\xc3\x97y;", "UTF-8标识符与多字节字符"},
+        {"int main() {\n\n  return 0;\n}\n", "换行与行号"},
+    };
+    for (const auto& test : tests) {
+        total++;
+        string expected = describe(analyzeAll(test.input));
+        bool ok = true;
+        for (size_t split = 0; split <= test.input.size() && ok; split++) {
+            ok = describe(pushInTwo(test.input, split)) == expected;
+            if (!ok) cout << "    在位置 " << split << " 切分时结果不同" << endl;
+        }
+        if (ok) passed++;
+        cout << "  " << test.description << ": " << (ok ? "✓" : "✗") << endl;
+    }
+    cout << endl;
+
+    // 测试组2：自动化测试用例按不同分段大小推送
+    cout << "测试组 2: 自动化测试用例按不同分段大小推送" << endl;
+    cout << "─────────────────────────────────────" << endl;
+    const char* cases[] = {"basic", "comments", "keywords", "operators", "debug1", "debug2"};
+    const size_t chunkSizes[] = {1, 2, 3, 7, 64, 4096};
+    for (const char* name : cases) {
+        ifstream in(string("../test_automation/test_cases/") + name + ".c");
+        if (!in) {
+            cout << "  " << name << ": 跳过（找不到用例文件）" << endl;
+            continue;
+        }
+        stringstream ss;
+        ss << in.rdbuf();
+        string input = ss.str();
+
+        total++;
+        string expected = describe(analyzeAll(input));
+        bool ok = true;
+        for (size_t size : chunkSizes) {
+            if (describe(pushInChunks(input, size)) != expected) {
+                cout << "    分段大小 " << size << " 时结果不同" << endl;
+                ok = false;
+            }
+        }
+        if (ok) passed++;
+        cout << "  " << name << ": " << (ok ? "✓" : "✗") << endl;
+    }
+    cout << endl;
+
+    // 测试组3：20MB的块注释按64KB分段推送，总耗时应与一次性分析同一量级
+    cout << "测试组 3: 超长跨段Token不会反复重扫" << endl;
+    cout << "─────────────────────────────────────" << endl;
+    string big = "int a;\n/*";
+    while (big.size() < 20 * 1024 * 1024) big += " long comment line\n";
+    big += "*/\nint b;\n";
+
+    auto start = chrono::steady_clock::now();
+    vector<Token> whole = analyzeAll(big);
+    double wholeMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    start = chrono::steady_clock::now();
+    vector<Token> pushed = pushInChunks(big, 64 * 1024);
+    double pushMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    total++;
+    // 未完成部分翻倍才重扫，总扫描量不超过输入的2倍，留出余量取5倍
+    bool ok = describe(pushed) == describe(whole) && pushMs < 5 * wholeMs + 50;
+    if (ok) passed++;
+    cout << "  一次性分析: " << wholeMs << " 毫秒" << endl;
+    cout << "  64KB分段推送: " << pushMs << " 毫秒" << endl;
+    cout << "  状态: " << (ok ? "✓" : "✗") << endl;
+    cout << endl;
+
+    cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << endl;
+    cout << "测试完成: " << passed << "/" << total << " 通过" << endl;
+    cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << endl;
+
+    return passed == total ? 0 : 1;
+}
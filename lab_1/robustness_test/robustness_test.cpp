@@ -89,9 +89,13 @@ int main() {
     cout << "═══════════════════════════════════════" << endl;
     cout << endl;
 
-    testCase("中文字符",
+    testCase("中文标识符",
              "int 变量 = 10;",
-             "包含中文（非法字符）");
+             "UTF-8编码的中文标识符（XID_Start/XID_Continue）");
+
+    testCase("非法UTF-8字节",
+             "int a\xff\xfe = 10;",
+             "非法UTF-8序列（跳过）");
 
     testCase("特殊符号",
              "int a @ = 10;",
@@ -0,0 +1,159 @@
+// 病态输入压力测试程序
+// 用超大规模的极端输入测量词法分析时间随输入规模的增长：在1倍、3倍、9倍三种规模下
+// 比较每字节耗时，较大规模的每字节耗时超过1倍规模的阈值倍即判定失败，用于发现意外的平方级路径
+
+#include "../LexAnalysis.h"
+#include <chrono>
+#include <climits>
+#include <functional>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+/* 生成指定规模输入的函数 */
+typedef function<string(size_t)> InputGenerator;
+
+/* 各次测量的规模倍数 */
+const size_t scaleFactors[] = {1, 3, 9};
+const int scaleCount = sizeof(scaleFactors) / sizeof(scaleFactors[0]);
+
+/* 一轮测量至少持续的时间（毫秒）：输入很小时一轮分析多遍取平均，计时精度不影响每字节耗时 */
+const double minRoundMs = 20.0;
+
+/* 对同一输入测量repeat轮，返回最短一轮中平均每遍分析的耗时（毫秒） */
+double measureLexTime(const string& input, int repeat) {
+    // 先分析一遍，估计每轮需要分析几遍
+    int passes = 1;
+    double best = -1;
+    for (int r = 0; r < repeat; r++) {
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < passes; i++) {
+            LexicalAnalyzer analyzer(input.data(), input.size());
+            analyzer.analyze();
+        }
+        auto end = chrono::steady_clock::now();
+        double ms = chrono::duration<double, milli>(end - start).count() / passes;
+        if (best < 0 || ms < best) best = ms;
+        if (r == 0 && ms * passes < minRoundMs) {
+            passes = (int)(minRoundMs / (ms > 0.001 ? ms : 0.001)) + 1;
+            r = -1;  // 第一遍只用于估计，按新的遍数重新测量
+            best = -1;
+        }
+    }
+    return best;
+}
+
+/* 测试一种病态输入：比较各规模的每字节耗时，返回是否通过 */
+bool stressCase(const string& name, const string& description,
+                size_t baseSize, const InputGenerator& generate, double maxGrowth) {
+    cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << endl;
+    cout << "测试: " << name << endl;
+    cout << "说明: " << description << endl;
+
+    double basePerByte = 0, growth = 0;
+    for (int i = 0; i < scaleCount; i++) {
+        string input = generate(baseSize * scaleFactors[i]);
+        double ms = measureLexTime(input, i == 0 ? 5 : 2);
+        double perByte = ms * 1e6 / input.size();  // 纳秒/字节
+        cout << scaleFactors[i] << "倍规模: " << input.size() << " 字节, " << ms << " 毫秒, "
+             << perByte << " 纳秒/字节" << endl;
+        if (i == 0) {
+            basePerByte = perByte;
+        } else if (perByte / basePerByte > growth) {
+            growth = perByte / basePerByte;
+        }
+    }
+
+    bool ok = growth <= maxGrowth;
+    cout << "每字节耗时最大增长: " << growth << "倍（阈值 " << maxGrowth << "）" << endl;
+    cout << "状态: " << (ok ? "✓ 线性增长" : "✗ 超线性增长") << endl;
+    cout << endl;
+    return ok;
+}
+
+int main(int argc, char* argv[]) {
+    // 参数1：规模缩放系数（默认1.0，即最大输入90MB）；参数2：每字节耗时增长的阈值（默认3）
+    double scale = argc > 1 ? atof(argv[1]) : 1.0;
+    double maxGrowth = argc > 2 ? atof(argv[2]) : 3.0;
+    if (scale <= 0) scale = 1.0;
+    const size_t MB = 1024 * 1024;
+
+#if defined(__GLIBC__)
+    // 大块内存默认直接mmap、释放即归还系统，大规模的每次测量都要重新缺页，
+    // 而小规模可以复用堆中已映射的内存，二者不可比；这里让大块内存都留在堆中复用。
+    // 9倍规模的连续运算符用例Token数组扩容时堆顶超过1GB，收缩阈值取int的最大值
+    mallopt(M_MMAP_THRESHOLD, 1 << 30);
+    mallopt(M_TRIM_THRESHOLD, INT_MAX);
+#endif
+
+    cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << endl;
+    cout << "词法分析器病态输入压力测试" << endl;
+    cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << endl;
+    cout << "规模系数: " << scale << "，每字节耗时增长阈值: " << maxGrowth << endl;
+    cout << endl;
+
+    int total = 0, passed = 0;
+
+    // 测试1：未闭合的超长块注释（9倍规模为90MB）
+    total++;
+    passed += stressCase("未闭合块注释", "以/*开头、直到文件末尾都没有*/",
+        (size_t)(10 * MB * scale), [](size_t n) {
+            string s = "/*";
+            while (s.size() < n) s += "* / comment text *\n";
+            return s;
+        }, maxGrowth);
+
+    // 测试2：单个超长标识符（9倍规模为45MB）
+    total++;
+    passed += stressCase("超长标识符", "整个输入只有一个标识符",
+        (size_t)(5 * MB * scale), [](size_t n) {
+            string s(n, 'a');
+            for (size_t i = 1; i < n; i += 7) s[i] = (char)('0' + i % 10);
+            s[n - 1] = '_';
+            return s;
+        }, maxGrowth);
+
+    // 测试3：数百万个连续运算符（无空白分隔，反复触发最长匹配回退）
+    total++;
+    passed += stressCase("连续运算符", "<<=>>=->++--&&||!=等运算符首尾相接",
+        (size_t)(2 * MB * scale), [](size_t n) {
+            const string ops = "<<=>>=->++--&&||!===<=>=*=/=%=^=|=&=+=-=";
+            string s;
+            while (s.size() < n) s += ops;
+            return s;
+        }, maxGrowth);
+
+    // 测试4：密集转义的超长字符串
+    total++;
+    passed += stressCase("密集转义字符串", "字符串内容全部由\\\\、\\\"等转义序列组成",
+        (size_t)(8 * MB * scale), [](size_t n) {
+            string s = "\"";
+            while (s.size() < n) s += "\\\\\\\"\\n\\\\\\\\\\\"";
+            s += "\"";
+            return s;
+        }, maxGrowth);
+
+    // 测试5：大量空行和行注释（行号累加与行注释扫描）
+    total++;
+    passed += stressCase("海量行注释", "每行都是行注释，夹杂空行",
+        (size_t)(8 * MB * scale), [](size_t n) {
+            string s;
+            while (s.size() < n) s += "// line comment /* not block */\n\n";
+            return s;
+        }, maxGrowth);
+
+    // 测试6：未闭合字符串中的非ASCII字符
+    total++;
+    passed += stressCase("未闭合UTF-8字符串", "以\"开头的超长中文内容，直到文件末尾",
+        (size_t)(8 * MB * scale), [](size_t n) {
+            string s = "\"";
+            while (s.size() < n) s += "词法分析\n";
+            return s;
+        }, maxGrowth);
+
+    cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << endl;
+    cout << "压力测试完成: " << passed << "/" << total << " 通过" << endl;
+    cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << endl;
+
+    return passed == total ? 0 : 1;
+}
@@ -59,6 +59,57 @@ for test_file in test_cases/*.c; do
     fi
 done
 
+# 缓存模式：每个用例运行两次（第一次未命中并写入缓存，第二次命中），输出都必须与期望一致
+cache_dir=$(mktemp -d)
+for test_file in test_cases/*.c; do
+    test_name=$(basename "$test_file" .c)
+    expected_file="expected_outputs/${test_name}.txt"
+    if [ ! -f "$test_file" ] || [ ! -f "$expected_file" ]; then
+        continue
+    fi
+
+    for round in 写入 命中; do
+        total=$((total + 1))
+        echo -n "测试用例 ${total}: ${test_name}（缓存${round}） ... "
+        LEX_CACHE_DIR="$cache_dir" ./test_runner < "$test_file" > output.tmp 2>&1
+        if diff -q output.tmp "$expected_file" > /dev/null 2>&1; then
+            echo "✓ 通过"
+            passed=$((passed + 1))
+        else
+            echo "✗ 失败"
+            failed=$((failed + 1))
+            diff output.tmp "$expected_file" | head -10
+        fi
+    done
+done
+
+# 模拟其他分支（Token编号不同）写入的结果：把文件头中的分析器标识和第一个Token的编号改为其他值，
+# 缓存不能命中，输出仍与期望一致（文件头48字节，记录中的编号在偏移16处）
+for cache_file in "$cache_dir"/*.lexc; do
+    printf '\xff\xff\xff\xff\xff\xff\xff\xff' | dd of="$cache_file" bs=1 seek=8 conv=notrunc 2>/dev/null
+    printf '\x63' | dd of="$cache_file" bs=1 seek=64 conv=notrunc 2>/dev/null
+done
+for test_file in test_cases/*.c; do
+    test_name=$(basename "$test_file" .c)
+    expected_file="expected_outputs/${test_name}.txt"
+    if [ ! -f "$test_file" ] || [ ! -f "$expected_file" ]; then
+        continue
+    fi
+
+    total=$((total + 1))
+    echo -n "测试用例 ${total}: ${test_name}（缓存来自其他分析器） ... "
+    LEX_CACHE_DIR="$cache_dir" ./test_runner < "$test_file" > output.tmp 2>&1
+    if diff -q output.tmp "$expected_file" > /dev/null 2>&1; then
+        echo "✓ 通过"
+        passed=$((passed + 1))
+    else
+        echo "✗ 失败"
+        failed=$((failed + 1))
+        diff output.tmp "$expected_file" | head -10
+    fi
+done
+rm -rf "$cache_dir"
+
 # 清理临时文件
 rm -f output.tmp
 
@@ -404,6 +404,10 @@ public:
         scan();
     }
 
+    const vector<VisualToken>& getTokens() const {
+        return tokens;
+    }
+
     void displayColorful() {
         cout << BOLD << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << RESET << endl;
         cout << BOLD << "词法分析可视化结果" << RESET << endl;
@@ -436,6 +440,8 @@ public:
     }
 };
 
+// 模糊测试直接包含本文件，需要去掉main
+#ifndef VISUALIZER_NO_MAIN
 int main() {
     string prog;
     char c;
@@ -449,3 +455,4 @@ int main() {
 
     return 0;
 }
+#endif
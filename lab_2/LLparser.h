@@ -1,3 +1,4 @@
+#include <cstdint>
 #include <cstdio>
 #include <cstring>
 #include <iostream>
@@ -9,6 +10,12 @@
 #include <set>
 #include <stack>
 #include <algorithm>
+#include <memory>
+#include "../common/FirstFollow.h"
+#include "../common/GrammarFile.h"
+#include "../common/AnalysisCache.h"
+#include "../common/c_subset_ll1.h"
+#include "../lab_1/BasicLexicalAnalyzer.h"
 using namespace std;
 
 /* 不要修改这个标准输入函数 */
@@ -20,168 +27,199 @@ void read_prog(string& prog)
     }
 }
 
+// ============================================================
+// TokenKind：token种类（终结符）的整数编号
+// 词法分析只产生编号，语法分析时再通过tokenKindName()取得
+// 与文法中终结符一致的名称
+// ============================================================
+enum TokenKind {
+    TK_LBRACE, TK_RBRACE, TK_LPAREN, TK_RPAREN, TK_SEMI, TK_ASSIGN,
+    TK_LT, TK_GT, TK_LE, TK_GE, TK_EQ,
+    TK_PLUS, TK_MINUS, TK_MUL, TK_DIV,
+    TK_IF, TK_THEN, TK_ELSE, TK_WHILE, TK_ID, TK_NUM,
+    TK_END,                     // 输入结束标记$
+    TOKEN_KIND_COUNT
+};
+
+// 返回token种类对应的终结符名称
+const string& tokenKindName(int kind) {
+    static const string names[TOKEN_KIND_COUNT] = {
+        "{", "}", "(", ")", ";", "=",
+        "<", ">", "<=", ">=", "==",
+        "+", "-", "*", "/",
+        "if", "then", "else", "while", "ID", "NUM",
+        "$"
+    };
+    return names[kind];
+}
+
 // ============================================================
 // Token类：表示词法单元
 // 功能：封装词法分析产生的每个token的信息
-// 包含：类型（type）、值（value）、行号（line）
+// 包含：种类（kind）、在输入中的位置（offset、length）、行号（line）
+// token的值不复制，需要时取prog.substr(offset, length)
 // ============================================================
 class Token {
 public:
-    string type;    // token类型，如ID、NUM、关键字（if、while等）、运算符等
-    string value;   // token的实际值，如变量名、数字值等
+    int kind;       // token种类，TokenKind中的编号
+    size_t offset;  // token在输入中的起始偏移
+    size_t length;  // token的长度
     int line;       // token所在行号，仅计算非空行，用于错误定位
 
-    // 构造函数：初始化token的三个属性
-    Token(const string& t = "", const string& v = "", int l = 1)
-        : type(t), value(v), line(l) {}
+    // 构造函数：初始化token的属性
+    Token(int k = TK_END, size_t o = 0, size_t len = 0, int l = 1)
+        : kind(k), offset(o), length(len), line(l) {}
+
+    // token种类对应的终结符名称，如ID、NUM、if、<=
+    const string& type() const {
+        return tokenKindName(kind);
+    }
 };
 
 // ============================================================
 // Lexer类：词法分析器
-// 功能：将输入的程序字符串分解为token序列
+// 功能：用实验一的SubsetLexicalAnalyzer（按子集文法配置实例化的词法分析器）识别token，
+//       再把实验一的Token编号转换为本实验的token种类
 // 特点：
-//   1. 按行处理输入，便于行号统计
+//   1. 直接在输入缓冲区上扫描，不复制输入
 //   2. 仅统计非空行，使行号与用户视角一致
-//   3. 支持双字符运算符（<=、>=、==）的识别
+//   3. next()每次只取一个token，语法分析器按需取用，不必先得到整个token序列
 // ============================================================
 class Lexer {
 private:
-    vector<string> lines;       // 按行分割的输入，每个元素是一行
-    int currentLineIdx;         // 当前处理的行索引（从0开始）
-    size_t posInLine;           // 当前行内的字符位置
+    lex::SubsetLexicalAnalyzer analyzer;    // 实验一的词法分析器，工作在增量模式
+    const char* input;          // 输入缓冲区，由调用方持有
+    size_t length;              // 输入长度
+    size_t counted;             // 行号已统计到的位置
     int contentLineNumber;      // 当前内容行号（仅计非空行）
-
-public:
-    // 构造函数：初始化词法分析器，按行分割输入
-    Lexer(const string& prog) : currentLineIdx(0), posInLine(0), contentLineNumber(0) {
-        // 使用stringstream按行分割输入字符串
-        stringstream ss(prog);
-        string line;
-        while (getline(ss, line)) {
-            lines.push_back(line);
-        }
-    }
-
-    // 检查当前行是否为空行（只包含空白字符）
-    // 空行不计入行号统计，使错误提示更符合用户直觉
-    bool isEmptyLine(const string& line) {
-        for (char c : line) {
-            // 非空白字符则不是空行
-            if (c != ' ' && c != '\t' && c != '\r') {
-                return false;
+    bool lineCounted;           // 当前行是否已计入行号
+    int physicalLine;           // 上一个token所在的物理行号（实验一的行号）
+
+    // 统计[counted, end)中的行：换行进入新的一行，遇到非空白字符（包括被跳过的未识别字符）
+    // 时该行成为非空行，增加内容行号
+    void countLines(size_t end) {
+        for (; counted < end; counted++) {
+            unsigned char c = input[counted];
+            if (c == '\n') {
+                lineCounted = false;
+            } else if (c != ' ' && c != '\t' && c != '\r' && !lineCounted) {
+                contentLineNumber++;
+                lineCounted = true;
             }
         }
-        return true;
+    }
+
+    // 实验一的Token编号 -> token种类；测试输入中直接出现的ID、NUM按对应的终结符处理，
+    // 实验四的int、real在本文法中不是关键字，按标识符处理
+    // 每个token都要转换一次，用常量表代替switch，避免难以预测的间接跳转
+    int kindOf(const lex::TokenSpan& t) const {
+        enum { I = TK_ID };
+        static const unsigned char kinds[84] = {
+            I, I, I, I, I, I, I, I, I, I,                                   // 0~9
+            TK_ELSE, I, I, I, I, I, TK_IF, I, I, I,                         // 10~19
+            I, I, I, I, I, I, I, I, I, I,                                   // 20~29
+            I, I, TK_WHILE, TK_MINUS, I, I, I, I, I, I,                     // 30~39
+            I, I, I, I, TK_LPAREN, TK_RPAREN, TK_MUL, I, I, I,              // 40~49
+            TK_DIV, I, I, TK_SEMI, I, I, I, I, I, TK_LBRACE,                // 50~59
+            I, I, I, TK_RBRACE, I, TK_PLUS, I, I, TK_LT, I,                 // 60~69
+            I, TK_LE, TK_ASSIGN, TK_EQ, TK_GT, TK_GE, I, I, I, I,           // 70~79
+            TK_NUM, I, TK_THEN, I                                           // 80~83
+        };
+        int kind = (size_t)t.code < sizeof(kinds) ? kinds[t.code] : (int)TK_ID;
+        if (kind == TK_ID && t.end - t.begin == 3 && memcmp(input + t.begin, "NUM", 3) == 0) {
+            return TK_NUM;
+        }
+        return kind;
+    }
+
+public:
+    // 构造函数：只记录输入的位置，prog在分析期间必须保持有效
+    Lexer(const string& prog) {
+        reset(prog);
+    }
+
+    // 没有输入的词法分析器，使用前先调用reset()
+    Lexer() : input(""), length(0), counted(0), contentLineNumber(0), lineCounted(false),
+              physicalLine(0) {}
+
+    // 从头开始分析prog
+    void reset(const string& prog) {
+        input = prog.data();
+        length = prog.size();
+        analyzer.reset(input, length);
+        counted = 0;
+        contentLineNumber = 0;
+        lineCounted = false;
+        physicalLine = 0;
     }
 
     // 词法分析主函数：将输入转换为token序列
     // 返回：包含所有token的vector，以$结束符结尾
     vector<Token> tokenize() {
-        vector<Token> tokens;  // 存储所有识别出的token
-
-        // 遍历所有行
-        while (currentLineIdx < (int)lines.size()) {
-            string& line = lines[currentLineIdx];
+        vector<Token> tokens;
+        tokenize(tokens);
+        return tokens;
+    }
 
-            // 跳过空行，不增加行号计数
-            if (isEmptyLine(line)) {
-                currentLineIdx++;
-                posInLine = 0;
-                continue;
-            }
+    // 同上，结果放入tokens（先清空），多次分析时复用tokens的容量
+    void tokenize(vector<Token>& tokens) {
+        tokens.clear();
+        tokens.reserve(length / 4 + 1);
+        analyzer.reset(input, length);
+        counted = 0;
+        contentLineNumber = 0;
+        lineCounted = false;
+        physicalLine = 0;
+
+        Token token;
+        do {
+            next(token);
+            tokens.push_back(token);
+        } while (token.kind != TK_END);
+    }
 
-            // 非空行，增加内容行号（用户可见的行号）
+    // 识别下一个token放入token；输入结束后总是得到输入结束标记$
+    void next(Token& token) {
+        lex::TokenSpan t;
+        if (!analyzer.nextSpan(t)) {
+            // 输入结束标记$，用于语法分析的终止判断
+            countLines(length);
+            token = Token(TK_END, length, 0, contentLineNumber);
+            return;
+        }
+        // 子集配置中的token都不跨行，token所在的行一定是非空行：与上一个token在同一物理行时
+        // 行号不变；在下一物理行时中间只有一个换行，内容行号加一；只有隔了若干行（其中可能有
+        // 空行或只有未识别字符的行）时才逐字节统计
+        if (t.line == physicalLine + 1) {
+            physicalLine = t.line;
             contentLineNumber++;
-
-            // 处理当前行的所有token
-            posInLine = 0;
-            while (posInLine < line.size()) {
-                // 跳过行内空白字符（空格和制表符）
-                while (posInLine < line.size() &&
-                       (line[posInLine] == ' ' || line[posInLine] == '\t')) {
-                    posInLine++;
-                }
-
-                // 行末检查
-                if (posInLine >= line.size()) break;
-
-                // 优先识别双字符运算符（<=、>=、==）
-                // 必须在单字符识别之前检查，避免<被错误识别
-                if (posInLine + 1 < line.size()) {
-                    string twoChar = line.substr(posInLine, 2);
-                    if (twoChar == "<=" || twoChar == ">=" || twoChar == "==") {
-                        tokens.push_back(Token(twoChar, twoChar, contentLineNumber));
-                        posInLine += 2;
-                        continue;
-                    }
-                }
-
-                // 识别单字符符号：括号、分号、运算符等
-                char c = line[posInLine];
-                if (c == '{' || c == '}' || c == '(' || c == ')' ||
-                    c == ';' || c == '=' || c == '<' || c == '>' ||
-                    c == '+' || c == '-' || c == '*' || c == '/') {
-                    string s(1, c);  // 将字符转为字符串
-                    tokens.push_back(Token(s, s, contentLineNumber));
-                    posInLine++;
-                    continue;
-                }
-
-                // 识别标识符和关键字
-                // 标识符以字母或下划线开头
-                if (isalpha(c) || c == '_') {
-                    string word;
-                    // 读取完整的标识符（字母、数字、下划线）
-                    while (posInLine < line.size() &&
-                           (isalnum(line[posInLine]) || line[posInLine] == '_')) {
-                        word += line[posInLine];
-                        posInLine++;
-                    }
-                    // 检查是否为保留关键字
-                    if (word == "if" || word == "then" || word == "else" || word == "while") {
-                        tokens.push_back(Token(word, word, contentLineNumber));
-                    } else if (word == "ID" || word == "NUM") {
-                        // ID和NUM在测试输入中作为特殊标记直接出现
-                        tokens.push_back(Token(word, word, contentLineNumber));
-                    } else {
-                        // 其他标识符统一归类为ID类型
-                        tokens.push_back(Token("ID", word, contentLineNumber));
-                    }
-                    continue;
-                }
-
-                // 识别数字常量
-                if (isdigit(c)) {
-                    string num;
-                    // 读取完整的数字
-                    while (posInLine < line.size() && isdigit(line[posInLine])) {
-                        num += line[posInLine];
-                        posInLine++;
-                    }
-                    tokens.push_back(Token("NUM", num, contentLineNumber));
-                    continue;
-                }
-
-                // 跳过其他未识别字符
-                posInLine++;
-            }
-
-            // 处理完当前行，移动到下一行
-            currentLineIdx++;
-            posInLine = 0;
+            lineCounted = true;
+        } else if (t.line != physicalLine) {
+            physicalLine = t.line;
+            countLines(t.end);
         }
-
-        // 添加输入结束标记$，用于语法分析的终止判断
-        tokens.push_back(Token("$", "$", contentLineNumber));
-        return tokens;
+        counted = t.end;
+        token = Token(kindOf(t), t.begin, t.end - t.begin, contentLineNumber);
     }
 };
 
+// ============================================================
+// Production结构：编号化的产生式
+// 产生式体是Grammar::productionSymbols中的一段[begin, begin + length)，
+// 空产生式（A -> E）的长度为0
+// ============================================================
+struct Production {
+    int lhs;        // 左部非终结符的编号
+    int begin;      // 产生式体在productionSymbols中的起始位置
+    int length;     // 产生式体的符号个数
+};
+
 // ============================================================
 // Grammar类：文法定义类
 // 功能：
 //   1. 存储文法的产生式
 //   2. 自动计算FIRST集合和FOLLOW集合
+//   3. 把所有符号编号，产生式存为编号序列
 // 文法采用实验指定的C语言子集文法
 // ============================================================
 class Grammar {
@@ -190,368 +228,824 @@ public:
     // 每个非终结符可以有多个产生式（用于选择）
     map<string, vector<vector<string>>> productions;
 
-    // FIRST集合：记录每个符号可能推导出的首终结符
-    map<string, set<string>> firstSets;
-
-    // FOLLOW集合：记录每个非终结符后面可能跟随的终结符
-    map<string, set<string>> followSets;
-
     // 非终结符集合
     set<string> nonTerminals;
 
     // 终结符集合
     set<string> terminals;
 
-    // 构造函数：初始化文法并计算FIRST/FOLLOW集合
-    Grammar() {
-        initGrammar();       // 初始化产生式
-        computeFirstSets();  // 计算FIRST集合
-        computeFollowSets(); // 计算FOLLOW集合
+    // ==================== 符号编号 ====================
+    // 终结符的编号与TokenKind相同（0 ~ TOKEN_KIND_COUNT-1），token种类可直接作为终结符编号；
+    // 非终结符按名称顺序从TOKEN_KIND_COUNT开始编号；空串E编号在最后，只用于语法树节点
+    vector<string> symbolNames;             // 编号 -> 符号名
+    map<string, int> symbolIds;             // 符号名 -> 编号
+    int epsilonId;                          // 空串E的编号
+
+    // 所有产生式体的符号编号依次拼接，每个产生式是其中的一段
+    vector<int> productionSymbols;
+    vector<Production> productionList;      // 所有产生式，下标即产生式编号
+    vector<vector<int>> productionsOf;      // 非终结符下标 -> 其产生式编号（按定义顺序）
+
+    // FIRST/FOLLOW集合与可空性，按符号编号查询，集合为终结符编号的位集
+    FirstFollowEngine analysis;
+
+    int startId;                            // 起始符号的编号
+    uint64_t hash;                          // 文法内容的散列值，分析缓存的键
+
+    // 构造函数：从文法文件初始化文法，为符号和产生式编号
+    // FIRST/FOLLOW集由computeFirstFollow()计算，或者从分析缓存恢复到analysis
+    Grammar(const GrammarFile& file) {
+        initGrammar(file);   // 读入产生式
+        internSymbols();     // 为符号和产生式编号
     }
 
-private:
-    // 初始化文法产生式
-    // 按照实验要求定义C语言子集的文法规则
-    void initGrammar() {
-        // 定义所有非终结符
-        nonTerminals = {"program", "stmt", "compoundstmt", "stmts", "ifstmt",
-                        "whilestmt", "assgstmt", "boolexpr", "boolop",
-                        "arithexpr", "arithexprprime", "multexpr", "multexprprime",
-                        "simpleexpr"};
-
-        // 定义所有终结符，E表示空串（epsilon）
-        terminals = {"{", "}", "if", "(", ")", "then", "else", "while",
-                     "ID", "=", ";", "<", ">", "<=", ">=", "==",
-                     "+", "-", "*", "/", "NUM", "E", "$"};
-
-        // ==================== 产生式定义 ====================
-
-        // program -> compoundstmt
-        // 程序由复合语句组成
-        productions["program"] = {{"compoundstmt"}};
-
-        // stmt -> ifstmt | whilestmt | assgstmt | compoundstmt
-        // 语句可以是if语句、while语句、赋值语句或复合语句
-        productions["stmt"] = {{"ifstmt"}, {"whilestmt"}, {"assgstmt"}, {"compoundstmt"}};
-
-        // compoundstmt -> { stmts }
-        // 复合语句由花括号包围的语句序列组成
-        productions["compoundstmt"] = {{"{", "stmts", "}"}};
-
-        // stmts -> stmt stmts | E
-        // 语句序列可以是一个语句后跟更多语句，或者为空
-        productions["stmts"] = {{"stmt", "stmts"}, {"E"}};
-
-        // ifstmt -> if ( boolexpr ) then stmt else stmt
-        // if语句的完整形式，包含then和else分支
-        productions["ifstmt"] = {{"if", "(", "boolexpr", ")", "then", "stmt", "else", "stmt"}};
-
-        // whilestmt -> while ( boolexpr ) stmt
-        // while循环语句
-        productions["whilestmt"] = {{"while", "(", "boolexpr", ")", "stmt"}};
-
-        // assgstmt -> ID = arithexpr ;
-        // 赋值语句：标识符 = 算术表达式 ;
-        productions["assgstmt"] = {{"ID", "=", "arithexpr", ";"}};
-
-        // boolexpr -> arithexpr boolop arithexpr
-        // 布尔表达式由两个算术表达式和一个比较运算符组成
-        productions["boolexpr"] = {{"arithexpr", "boolop", "arithexpr"}};
-
-        // boolop -> < | > | <= | >= | ==
-        // 比较运算符
-        productions["boolop"] = {{"<"}, {">"}, {"<="}, {">="}, {"=="}};
-
-        // arithexpr -> multexpr arithexprprime
-        // 算术表达式由乘法表达式和算术表达式后缀组成
-        productions["arithexpr"] = {{"multexpr", "arithexprprime"}};
-
-        // arithexprprime -> + multexpr arithexprprime | - multexpr arithexprprime | E
-        // 算术表达式后缀处理加减运算，使用左递归消除
-        productions["arithexprprime"] = {{"+", "multexpr", "arithexprprime"},
-                                         {"-", "multexpr", "arithexprprime"},
-                                         {"E"}};
-
-        // multexpr -> simpleexpr multexprprime
-        // 乘法表达式由简单表达式和乘法表达式后缀组成
-        productions["multexpr"] = {{"simpleexpr", "multexprprime"}};
-
-        // multexprprime -> * simpleexpr multexprprime | / simpleexpr multexprprime | E
-        // 乘法表达式后缀处理乘除运算
-        productions["multexprprime"] = {{"*", "simpleexpr", "multexprprime"},
-                                        {"/", "simpleexpr", "multexprprime"},
-                                        {"E"}};
-
-        // simpleexpr -> ID | NUM | ( arithexpr )
-        // 简单表达式：标识符、数字或括号表达式
-        productions["simpleexpr"] = {{"ID"}, {"NUM"}, {"(", "arithexpr", ")"}};
-    }
-
-    // 计算单个符号的FIRST集合（递归算法）
-    // 参数：symbol - 要计算FIRST集合的符号
-    // 返回：该符号的FIRST集合
-    set<string> computeFirst(const string& symbol) {
-        set<string> result;
-
-        // 规则1：如果是终结符，FIRST(X) = {X}
-        if (terminals.count(symbol)) {
-            result.insert(symbol);
-            return result;
-        }
-
-        // 如果已计算过（避免重复计算和无限递归）
-        if (firstSets.count(symbol) && !firstSets[symbol].empty()) {
-            return firstSets[symbol];
-        }
-
-        // 规则2：对于非终结符，遍历所有产生式
-        for (const auto& prod : productions[symbol]) {
-            // 处理空产生式 X -> E
-            if (prod.size() == 1 && prod[0] == "E") {
-                result.insert("E");
-                continue;
-            }
+    // 非终结符个数
+    int nonTerminalCount() const {
+        return (int)nonTerminals.size();
+    }
 
-            // 计算产生式体 Y1Y2...Yk 的FIRST
-            bool allHaveEpsilon = true;
-            for (const auto& s : prod) {
-                set<string> firstOfS = computeFirst(s);
+    // 编号是否为非终结符
+    bool isNonTerminal(int id) const {
+        return id >= TOKEN_KIND_COUNT && id < epsilonId;
+    }
 
-                // 将FIRST(Yi) - {E}加入FIRST(X)
-                for (const auto& f : firstOfS) {
-                    if (f != "E") result.insert(f);
-                }
+    // 编号对应的符号名
+    const string& symbolName(int id) const {
+        return symbolNames[id];
+    }
 
-                // 如果Yi不能推导出空串，停止
-                if (firstOfS.find("E") == firstOfS.end()) {
-                    allHaveEpsilon = false;
-                    break;
-                }
-            }
+private:
+    string startName;                       // 起始符号名，编号后得到startId
 
-            // 如果所有Yi都能推导出E，则将E加入FIRST(X)
-            if (allHaveEpsilon) {
-                result.insert("E");
-            }
+    // 从文法文件读入产生式（文法见common/c_subset.bnf）
+    void initGrammar(const GrammarFile& file) {
+        for (const GrammarRule& rule : file.rules) {
+            nonTerminals.insert(rule.lhs);
+            productions[rule.lhs] = rule.alternatives;
         }
 
-        return result;
+        // 终结符，E表示空串（epsilon）
+        for (const string& t : file.terminals()) {
+            terminals.insert(t);
+        }
+        terminals.insert("E");
+        terminals.insert("$");
+        startName = file.startSymbol();
+        hash = file.hash;
     }
 
-    // 计算所有符号的FIRST集合
-    void computeFirstSets() {
-        // 首先初始化终结符的FIRST集合
-        for (const auto& t : terminals) {
-            firstSets[t].insert(t);
+    // 为所有符号编号，并把产生式转换为编号序列
+    void internSymbols() {
+        // 终结符按TokenKind的顺序编号，与词法分析器的输出一致
+        for (int k = 0; k < TOKEN_KIND_COUNT; k++) {
+            symbolIds[tokenKindName(k)] = k;
+            symbolNames.push_back(tokenKindName(k));
         }
+        for (const auto& nt : nonTerminals) {
+            symbolIds[nt] = (int)symbolNames.size();
+            symbolNames.push_back(nt);
+        }
+        epsilonId = (int)symbolNames.size();
+        symbolNames.push_back("E");
+
+        startId = symbolIds.at(startName);
 
-        // 然后计算非终结符的FIRST集合
+        productionsOf.assign(nonTerminals.size(), vector<int>());
         for (const auto& nt : nonTerminals) {
-            firstSets[nt] = computeFirst(nt);
+            int lhs = symbolIds[nt];
+            for (const auto& body : productions[nt]) {
+                Production prod;
+                prod.lhs = lhs;
+                prod.begin = (int)productionSymbols.size();
+                // 空产生式的产生式体为空
+                if (!(body.size() == 1 && body[0] == "E")) {
+                    for (const auto& sym : body) {
+                        auto it = symbolIds.find(sym);
+                        if (it == symbolIds.end()) {
+                            // 终结符的编号来自TokenKind，词法分析器不产生的终结符无法分析
+                            cerr << "文法错误: \"" << sym << "\"不是词法分析器产生的终结符" << endl;
+                            exit(1);
+                        }
+                        productionSymbols.push_back(it->second);
+                    }
+                }
+                prod.length = (int)productionSymbols.size() - prod.begin;
+                productionsOf[lhs - TOKEN_KIND_COUNT].push_back((int)productionList.size());
+                productionList.push_back(prod);
+            }
         }
     }
 
-    // 计算所有非终结符的FOLLOW集合
-    // 使用迭代法，直到不再有新元素加入为止
-    void computeFollowSets() {
-        // 初始化所有FOLLOW集合为空
-        for (const auto& nt : nonTerminals) {
-            followSets[nt] = set<string>();
+public:
+    // 计算FIRST集合和FOLLOW集合
+    // 把编号化的产生式交给FirstFollowEngine，用位集和工作表求不动点
+    void computeFirstFollow() {
+        analysis = FirstFollowEngine(TOKEN_KIND_COUNT, nonTerminalCount());
+        for (const Production& prod : productionList) {
+            analysis.addProduction(prod.lhs, productionSymbols.data() + prod.begin, prod.length);
         }
 
-        // 规则1：将$加入起始符号的FOLLOW集合
-        followSets["program"].insert("$");
+        // 将$加入起始符号的FOLLOW集合
+        analysis.addFollow(startId, TK_END);
+        analysis.compute();
+    }
 
-        // 迭代计算，直到不动点（不再变化）
-        bool changed = true;
-        while (changed) {
-            changed = false;
+    // 从分析缓存恢复FIRST/FOLLOW集合，代替computeFirstFollow()
+    // 返回：缓存数据与本文法的符号个数是否相符
+    bool restoreFirstFollow(const uint64_t* state, size_t n) {
+        analysis = FirstFollowEngine(TOKEN_KIND_COUNT, nonTerminalCount());
+        return analysis.restoreState(state, n);
+    }
+};
 
-            // 遍历所有产生式
-            for (const auto& prodPair : productions) {
-                const string& lhs = prodPair.first;  // 产生式左部A
+// ============================================================
+// ParseTable类：LL(1)分析表
+// 功能：根据文法的FIRST和FOLLOW集合构建预测分析表
+// 表结构：非终结符数 × 终结符数的平铺数组，
+//         table[(A - TOKEN_KIND_COUNT) * TOKEN_KIND_COUNT + a] = 产生式编号
+// 同时为每个非终结符准备错误恢复用的终结符集合，出错时不必再查FOLLOW集合、扫描产生式
+// 文法不是LL(1)时，有多个候选产生式的表项记为冲突，由AdaptivePredictor向前多看token决定
+// ============================================================
+class ParseTable {
+public:
+    // 分析表：每次预测只需一次下标访问，-1表示无对应表项，
+    // -2 - c表示冲突表项，候选产生式为conflicts[c]
+    vector<int16_t> table;
 
-                for (const auto& prod : prodPair.second) {
-                    // 对于产生式A -> αBβ中的每个非终结符B
-                    for (size_t i = 0; i < prod.size(); i++) {
-                        const string& B = prod[i];
+    // 冲突表项的候选产生式，按产生式编号排列；LL(1)文法没有冲突表项
+    vector<vector<int>> conflicts;
 
-                        // 只处理非终结符
-                        if (nonTerminals.find(B) == nonTerminals.end()) continue;
+    // 非终结符 - TOKEN_KIND_COUNT -> 表项为空时按空产生式恢复的向前看符号
+    vector<TerminalSet> epsilonRecovery;
 
-                        // 计算β的FIRST集合
-                        set<string> firstOfBeta;
-                        bool betaHasEpsilon = true;
+    // 非终结符 - TOKEN_KIND_COUNT -> 同步集合：有表项或可按空产生式恢复的向前看符号，
+    // 其余的向前看符号出错时被跳过
+    vector<TerminalSet> syncSets;
 
-                        for (size_t j = i + 1; j < prod.size(); j++) {
-                            const string& beta = prod[j];
-                            set<string>& firstBeta = firstSets[beta];
+    // 对文法的引用，用于获取产生式（只读）
+    const Grammar& grammar;
 
-                            // 将FIRST(β) - {E}加入
-                            for (const auto& f : firstBeta) {
-                                if (f != "E") firstOfBeta.insert(f);
-                            }
+    // 构造函数：分析表由buildTable()构建，或者由restore()从分析缓存恢复
+    ParseTable(const Grammar& g) : grammar(g) {}
 
-                            // 如果β不能推导出E，停止
-                            if (firstBeta.find("E") == firstBeta.end()) {
-                                betaHasEpsilon = false;
-                                break;
-                            }
-                        }
+private:
+    // 表项M[A,a]的位置
+    size_t index(int nonTerminal, int terminal) const {
+        return (size_t)(nonTerminal - TOKEN_KIND_COUNT) * TOKEN_KIND_COUNT + terminal;
+    }
 
-                        // 规则2：将FIRST(β) - {E}加入FOLLOW(B)
-                        for (const auto& f : firstOfBeta) {
-                            if (followSets[B].find(f) == followSets[B].end()) {
-                                followSets[B].insert(f);
-                                changed = true;  // 有新元素加入
-                            }
-                        }
+public:
+    // 构建LL(1)分析表
+    // 算法：对于每个产生式A -> α
+    //   1. 对于FIRST(α)中的每个终结符a，将产生式加入M[A,a]
+    //   2. 如果E在FIRST(α)中，对于FOLLOW(A)中的每个终结符b，将产生式加入M[A,b]
+    // 同一表项加入了多个产生式时成为冲突表项
+    void buildTable() {
+        vector<vector<int>> candidates((size_t)grammar.nonTerminalCount() * TOKEN_KIND_COUNT);
+        auto add = [&](int nonTerminal, int terminal, int p) {
+            vector<int>& cell = candidates[index(nonTerminal, terminal)];
+            if (cell.empty() || cell.back() != p) cell.push_back(p);
+        };
 
-                        // 规则3：如果β可以推导出E或B在产生式末尾
-                        // 将FOLLOW(A)加入FOLLOW(B)
-                        if (betaHasEpsilon || i == prod.size() - 1) {
-                            for (const auto& f : followSets[lhs]) {
-                                if (followSets[B].find(f) == followSets[B].end()) {
-                                    followSets[B].insert(f);
-                                    changed = true;
-                                }
-                            }
-                        }
-                    }
+        // 遍历所有产生式
+        for (int p = 0; p < (int)grammar.productionList.size(); p++) {
+            const Production& prod = grammar.productionList[p];
+
+            // 计算产生式体α的FIRST集合，并判断α能否推导出E（空产生式也可以）
+            TerminalSet firstAlpha(TOKEN_KIND_COUNT);
+            bool hasEpsilon = grammar.analysis.firstOfSequence(
+                grammar.productionSymbols.data() + prod.begin, prod.length, firstAlpha);
+
+            // 规则1：对于FIRST(α)中的每个终结符a，M[A,a] = p
+            firstAlpha.forEach([&](int a) {
+                add(prod.lhs, a, p);
+            });
+
+            // 规则2：如果α可以推导出E，对于FOLLOW(A)中的每个终结符b
+            if (hasEpsilon) {
+                grammar.analysis.follow(prod.lhs).forEach([&](int b) {
+                    add(prod.lhs, b, p);
+                });
+            }
+        }
+
+        table.assign(candidates.size(), -1);
+        conflicts.clear();
+        for (size_t i = 0; i < candidates.size(); i++) {
+            if (candidates[i].size() == 1) {
+                table[i] = (int16_t)candidates[i][0];
+            } else if (candidates[i].size() > 1) {
+                table[i] = (int16_t)(-2 - (int)conflicts.size());
+                conflicts.push_back(candidates[i]);
+            }
+        }
+        buildRecoverySets();
+    }
+
+    // 冲突表项按分析缓存的格式展开：依次为每个冲突的候选数和各候选产生式编号
+    vector<int16_t> saveConflicts() const {
+        vector<int16_t> data;
+        for (const auto& cell : conflicts) {
+            data.push_back((int16_t)cell.size());
+            data.insert(data.end(), cell.begin(), cell.end());
+        }
+        return data;
+    }
+
+    // 从分析缓存恢复分析表和冲突表项（saveConflicts()的格式），大小和表项不合法时返回false
+    bool restore(const int16_t* cached, size_t n, const vector<int16_t>& cachedConflicts) {
+        if (n != (size_t)grammar.nonTerminalCount() * TOKEN_KIND_COUNT) {
+            return false;
+        }
+        int productionCount = (int)grammar.productionList.size();
+        vector<vector<int>> cells;
+        for (size_t i = 0; i < cachedConflicts.size(); i += 1 + cachedConflicts[i]) {
+            int count = cachedConflicts[i];
+            if (count < 2 || i + count >= cachedConflicts.size()) return false;
+            vector<int> cell(cachedConflicts.begin() + i + 1, cachedConflicts.begin() + i + 1 + count);
+            for (int p : cell) {
+                if (p < 0 || p >= productionCount) return false;
+            }
+            cells.push_back(cell);
+        }
+        for (size_t i = 0; i < n; i++) {
+            if (cached[i] >= productionCount || -2 - cached[i] >= (int)cells.size()) {
+                return false;
+            }
+        }
+        table.assign(cached, cached + n);
+        conflicts.swap(cells);
+        buildRecoverySets();
+        return true;
+    }
+
+    // 表项M[A,a]为空时是否按空产生式恢复（LLParser::handleError的策略1～3）
+    bool recoversWithEpsilon(int nonTerminal, int terminal) const {
+        return epsilonRecovery[nonTerminal - TOKEN_KIND_COUNT].contains(terminal);
+    }
+
+    // 出错跳过token时，terminal是否可以让nonTerminal重新展开或恢复
+    bool isSync(int nonTerminal, int terminal) const {
+        return syncSets[nonTerminal - TOKEN_KIND_COUNT].contains(terminal);
+    }
+
+private:
+    // 由分析表和FOLLOW集合计算各非终结符的恢复集合和同步集合
+    //   策略1：向前看符号在FOLLOW(A)中
+    //   策略2：stmts遇到}，说明语句序列结束
+    //   策略3：A有空产生式，任何向前看符号都按空产生式恢复
+    void buildRecoverySets() {
+        int count = grammar.nonTerminalCount();
+        epsilonRecovery.assign(count, TerminalSet(TOKEN_KIND_COUNT));
+        syncSets.assign(count, TerminalSet(TOKEN_KIND_COUNT));
+        for (int n = 0; n < count; n++) {
+            int nonTerminal = n + TOKEN_KIND_COUNT;
+            TerminalSet& recovery = epsilonRecovery[n];
+            recovery.unite(grammar.analysis.follow(nonTerminal));
+            if (grammar.symbolName(nonTerminal) == "stmts") {
+                recovery.insert(TK_RBRACE);
+            }
+            for (int p : grammar.productionsOf[n]) {
+                if (grammar.productionList[p].length == 0) {
+                    for (int t = 0; t < TOKEN_KIND_COUNT; t++) recovery.insert(t);
+                    break;
                 }
             }
+
+            syncSets[n].unite(recovery);
+            for (int t = 0; t < TOKEN_KIND_COUNT; t++) {
+                if (lookup(nonTerminal, t) != -1) syncSets[n].insert(t);
+            }
         }
     }
+
+public:
+    // 根据非终结符和当前输入获取对应的产生式编号
+    // 返回：产生式编号，-1表示错误，小于-1表示冲突表项（见candidates()）
+    int lookup(int nonTerminal, int terminal) const {
+        return table[index(nonTerminal, terminal)];
+    }
+
+    // 冲突表项entry（lookup()返回的小于-1的值）的候选产生式
+    const vector<int>& candidates(int entry) const {
+        return conflicts[-2 - entry];
+    }
 };
 
 // ============================================================
-// ParseTable类：LL(1)分析表
-// 功能：根据文法的FIRST和FOLLOW集合构建预测分析表
-// 表结构：table[非终结符][终结符] = 产生式索引
+// TreeNode结构：语法树节点
+// 节点存放在ParseTree的节点数组中，以下标互相引用；
+// 子节点组成单链表：firstChild指向第一个子节点，nextSibling指向下一个兄弟
 // ============================================================
-class ParseTable {
+struct TreeNode {
+    int symbol;         // 节点符号的编号（终结符、非终结符或空串E）
+    int firstChild;     // 第一个子节点，-1表示没有
+    int lastChild;      // 最后一个子节点，追加子节点时使用
+    int nextSibling;    // 下一个兄弟节点，-1表示没有
+};
+
+// ============================================================
+// ParseTree类：语法树
+// 功能：
+//   1. 所有节点从一块连续的节点数组中顺序分配（bump分配），不逐个new
+//   2. 释放整棵树只需清空数组，与节点个数无关
+//   3. 前序遍历输出（带缩进）
+// ============================================================
+class ParseTree {
+private:
+    vector<TreeNode> nodes;     // 节点数组，下标即节点编号
+    const Grammar* grammar;     // 用于取得符号名
+
 public:
-    // 分析表：二维map实现，支持O(log n)的查询
-    map<string, map<string, int>> table;
+    int root;                   // 根节点，-1表示空树
 
-    // 对文法的引用，用于获取产生式
-    Grammar& grammar;
+    ParseTree(const Grammar& g) : grammar(&g), root(-1) {}
 
-    // 构造函数：根据文法构建分析表
-    ParseTable(Grammar& g) : grammar(g) {
-        buildTable();
+    // 释放所有节点，保留数组容量供下一次分析使用
+    void clear() {
+        nodes.clear();
+        root = -1;
     }
 
-private:
-    // 构建LL(1)分析表
-    // 算法：对于每个产生式A -> α
-    //   1. 对于FIRST(α)中的每个终结符a，将产生式加入M[A,a]
-    //   2. 如果E在FIRST(α)中，对于FOLLOW(A)中的每个终结符b，将产生式加入M[A,b]
-    void buildTable() {
-        // 遍历所有产生式
-        for (const auto& prodPair : grammar.productions) {
-            const string& A = prodPair.first;  // 非终结符
-            const vector<vector<string>>& prods = prodPair.second;  // 产生式列表
+    // 预留节点空间，避免分析过程中反复扩容
+    void reserve(size_t count) {
+        nodes.reserve(count);
+    }
 
-            for (size_t i = 0; i < prods.size(); i++) {
-                const vector<string>& alpha = prods[i];  // 产生式体
+    // 分配一个新节点，返回其编号
+    int newNode(int symbol) {
+        TreeNode node = {symbol, -1, -1, -1};
+        nodes.push_back(node);
+        return (int)nodes.size() - 1;
+    }
 
-                // 计算产生式体α的FIRST集合
-                set<string> firstAlpha;
-                bool hasEpsilon = true;
+    // 在parent的子节点末尾追加child
+    void addChild(int parent, int child) {
+        TreeNode& p = nodes[parent];
+        if (p.lastChild < 0) {
+            p.firstChild = child;
+        } else {
+            nodes[p.lastChild].nextSibling = child;
+        }
+        p.lastChild = child;
+    }
 
-                for (const auto& symbol : alpha) {
-                    // 遇到空产生式
-                    if (symbol == "E") {
-                        break;
-                    }
+    // 新建符号为symbol的节点并追加到parent的子节点末尾
+    int appendNode(int parent, int symbol) {
+        int child = newNode(symbol);
+        addChild(parent, child);
+        return child;
+    }
 
-                    set<string>& firstSym = grammar.firstSets[symbol];
-                    // 将FIRST(symbol) - {E}加入firstAlpha
-                    for (const auto& f : firstSym) {
-                        if (f != "E") firstAlpha.insert(f);
-                    }
+    const TreeNode& node(int id) const {
+        return nodes[id];
+    }
 
-                    // 如果symbol不能推导出E，停止
-                    if (firstSym.find("E") == firstSym.end()) {
-                        hasEpsilon = false;
-                        break;
-                    }
-                }
+    size_t size() const {
+        return nodes.size();
+    }
 
-                // 规则1：对于FIRST(α)中的每个终结符a，M[A,a] = i
-                for (const auto& a : firstAlpha) {
-                    table[A][a] = i;
+    // 输出语法树（前序遍历，每个节点一行，每层缩进一个tab）
+    // 非递归遍历：path保存从根到当前节点的祖先，其长度即当前深度；
+    // 输出先写入缓冲区，缓冲区满时才整块写出，缩进从预先生成的tab串中复制
+    void print(ostream& out = cout) const {
+        if (root < 0) {
+            return;
+        }
+        TreeWriter writer(out);
+        vector<int> path;
+        int id = root;
+        for (;;) {
+            writer.indent(path.size());
+            writer.line(grammar->symbolName(nodes[id].symbol));
+
+            // 有子节点时下降到第一个子节点
+            if (nodes[id].firstChild >= 0) {
+                path.push_back(id);
+                id = nodes[id].firstChild;
+                continue;
+            }
+            // 否则转到最近的有后继兄弟的祖先（或自身）的下一个兄弟
+            while (nodes[id].nextSibling < 0) {
+                if (path.empty()) {
+                    writer.flush();
+                    return;
                 }
+                id = path.back();
+                path.pop_back();
+            }
+            id = nodes[id].nextSibling;
+        }
+    }
 
-                // 规则2：如果α可以推导出E，对于FOLLOW(A)中的每个终结符b
-                if (hasEpsilon || (alpha.size() == 1 && alpha[0] == "E")) {
-                    for (const auto& b : grammar.followSets[A]) {
-                        // 避免覆盖已有表项（处理冲突）
-                        if (table[A].find(b) == table[A].end()) {
-                            table[A][b] = i;
-                        }
-                    }
+private:
+    // 语法树输出缓冲区
+    class TreeWriter {
+    private:
+        static const size_t BUFFER_SIZE = 1 << 16;
+        static const size_t TAB_COUNT = 256;
+
+        ostream& out;
+        vector<char> buffer;
+        size_t used;
+        string tabs;                // TAB_COUNT个tab，缩进从中复制
+
+        void append(const char* data, size_t length) {
+            while (length > 0) {
+                if (used == BUFFER_SIZE) {
+                    out.write(buffer.data(), used);
+                    used = 0;
                 }
+                size_t n = min(length, BUFFER_SIZE - used);
+                memcpy(&buffer[used], data, n);
+                used += n;
+                data += n;
+                length -= n;
             }
         }
-    }
 
-public:
-    // 根据非终结符和当前输入获取对应的产生式
-    // 返回：产生式体（符号序列），空表示错误
-    vector<string> getProduction(const string& nonTerminal, const string& terminal) {
-        if (table.count(nonTerminal) && table[nonTerminal].count(terminal)) {
-            int idx = table[nonTerminal][terminal];
-            return grammar.productions[nonTerminal][idx];
+    public:
+        explicit TreeWriter(ostream& o) : out(o), buffer(BUFFER_SIZE), used(0), tabs(TAB_COUNT, '\t') {}
+
+        void indent(size_t depth) {
+            while (depth > TAB_COUNT) {
+                append(tabs.data(), TAB_COUNT);
+                depth -= TAB_COUNT;
+            }
+            append(tabs.data(), depth);
         }
-        return vector<string>();  // 空向量表示错误
+
+        void line(const string& text) {
+            append(text.data(), text.size());
+            append("\n", 1);
+        }
+
+        // 写出缓冲区中剩余的内容
+        void flush() {
+            out.write(buffer.data(), used);
+            used = 0;
+            out.flush();
+        }
+    };
+};
+
+// ============================================================
+// 分析事件
+// LLParser::parse(prog, handler)在分析过程中按前序依次调用处理器的以下成员函数，
+// 处理器是模板参数，调用在编译时确定，空的成员函数会被完全内联掉：
+//   onEnter(int nonTerminal)             开始展开一个非终结符
+//   onToken(int symbol, const Token* t)  一个叶子：匹配的终结符（t为该token）、
+//                                        错误恢复插入的终结符或空串E（t为nullptr）
+//   onExit(int nonTerminal)              该非终结符的所有子节点都已产生
+//   onError(const string& message)       一条语法错误信息（同一行只报告一次）
+// 每个onEnter都有对应的onExit，叶子出现在最近一个未结束的非终结符之下
+// ============================================================
+
+// ============================================================
+// TreeBuilder：把分析事件还原为语法树的处理器
+// LLParser::parse(prog)使用它构建语法树并收集错误信息
+// ============================================================
+class TreeBuilder {
+private:
+    ParseTree& tree;
+    vector<int> open;           // 从根到当前非终结符的节点编号
+
+public:
+    vector<string> errors;      // 错误信息，按报告顺序
+
+    TreeBuilder(ParseTree& t) : tree(t) {}
+
+    // 开始构建新的一棵树：清空语法树和错误信息，保留各数组的容量
+    void reset() {
+        tree.clear();
+        open.clear();
+        errors.clear();
+    }
+
+    void onEnter(int nonTerminal) {
+        int node = open.empty() ? (tree.root = tree.newNode(nonTerminal))
+                                : tree.appendNode(open.back(), nonTerminal);
+        open.push_back(node);
     }
 
-    // 检查分析表中是否存在对应表项
-    bool hasEntry(const string& nonTerminal, const string& terminal) {
-        return table.count(nonTerminal) && table[nonTerminal].count(terminal);
+    void onToken(int symbol, const Token*) {
+        tree.appendNode(open.back(), symbol);
+    }
+
+    void onExit(int) {
+        open.pop_back();
+    }
+
+    void onError(const string& message) {
+        errors.push_back(message);
     }
 };
 
 // ============================================================
-// TreeNode类：语法树节点
-// 功能：表示语法分析生成的语法树的节点
-// 支持：子节点管理、递归输出（带缩进）
+// SyntaxChecker：只检查语法的处理器，不分配任何节点
 // ============================================================
-class TreeNode {
+class SyntaxChecker {
 public:
-    string symbol;              // 节点符号（终结符或非终结符名称）
-    vector<TreeNode*> children; // 子节点列表
+    vector<string> errors;
+
+    void onEnter(int) {}
+    void onToken(int, const Token*) {}
+    void onExit(int) {}
+
+    void onError(const string& message) {
+        errors.push_back(message);
+    }
+};
+
+// ============================================================
+// LLAnalysis类：文法和LL(1)分析表
+// 构造时完成文法分析（或从静态数组、分析缓存恢复），之后只能通过const引用访问；
+// 所有查询都是只读的，一个LLAnalysis可以供多个LLParser（包括不同线程中的）共用，
+// 每个分析器只保存各次分析的状态
+// ============================================================
+class LLAnalysis {
+private:
+    Grammar grammar;            // 文法定义
+    ParseTable parseTable;      // LL(1)分析表，引用grammar
+
+public:
+    // 参数：file - 文法，默认为与实验三共用的C语言子集文法
+    //       cachePath - 分析缓存文件，为空时每次都重新计算；
+    //                   文法未变时直接读取其中的FIRST/FOLLOW集合和分析表
+    LLAnalysis(const GrammarFile& file = cSubsetGrammar(), const string& cachePath = "")
+        : grammar(file), parseTable(grammar) {
+        prepare(cachePath);
+    }
+
+    // parseTable引用本对象的grammar，不能复制
+    LLAnalysis(const LLAnalysis&) = delete;
+    LLAnalysis& operator=(const LLAnalysis&) = delete;
+
+    const Grammar& getGrammar() const {
+        return grammar;
+    }
+
+    const ParseTable& getParseTable() const {
+        return parseTable;
+    }
+
+    // 与编译进程序的静态数组对应的文法（散列为C_SUBSET_LL1_HASH）的分析结果，
+    // 每个进程只在第一次调用时构造一次，之后所有使用该文法的LLParser共用，不再逐个恢复
+    static const LLAnalysis& precomputed(const GrammarFile& file) {
+        static const LLAnalysis shared(file);
+        return shared;
+    }
+
+private:
+    // 准备FIRST/FOLLOW集合和分析表：内置文法直接使用编译进程序的静态数组；
+    // 其他文法在缓存中有结果时直接读取，否则计算后写入缓存（缓存中其他分析器的区段保留）
+    void prepare(const string& cachePath) {
+        if (grammar.hash == C_SUBSET_LL1_HASH &&
+            grammar.restoreFirstFollow(C_SUBSET_LL1_STATE, sizeof(C_SUBSET_LL1_STATE) / sizeof(uint64_t)) &&
+            parseTable.restore(C_SUBSET_LL1_TABLE, sizeof(C_SUBSET_LL1_TABLE) / sizeof(int16_t),
+                               vector<int16_t>())) {
+            return;
+        }
+
+        AnalysisCache cache;
+        string data;
+        if (!cachePath.empty() && cache.load(cachePath, grammar.hash) && cache.get("ll1", data)) {
+            CacheReader reader(data);
+            vector<uint64_t> state;
+            vector<int16_t> cached, cachedConflicts;
+            if (reader.getArray(state) && reader.getArray(cached) && reader.getArray(cachedConflicts) &&
+                reader.atEnd() && grammar.restoreFirstFollow(state.data(), state.size()) &&
+                parseTable.restore(cached.data(), cached.size(), cachedConflicts)) {
+                return;
+            }
+        }
+
+        grammar.computeFirstFollow();
+        parseTable.buildTable();
+
+        if (!cachePath.empty()) {
+            CacheWriter writer;
+            writer.putArray(grammar.analysis.saveState());
+            writer.putArray(parseTable.table);
+            writer.putArray(parseTable.saveConflicts());
+            cache.put("ll1", writer.data);
+            cache.save(cachePath);
+        }
+    }
+};
+
+// ============================================================
+// AdaptivePredictor类：冲突表项的自适应预测（ALL(*)的简化形式）
+// 分析表的一格有多个候选产生式时，把各候选产生式当作在文法上并行前进的路径，
+// 依次读入后面的token模拟各条路径，直到只剩一个候选产生式还能继续：
+//   1. SLL模拟：只沿候选产生式及其展开前进，不看分析栈，结果只与读入的token有关，
+//      因此把每一步的路径集合作为DFA状态缓存下来，同一冲突表项再次出现时直接沿DFA前进
+//   2. LL模拟：有路径走完了当前非终结符而候选仍不唯一时，其后的符号由分析栈决定，
+//      改为从头沿实际的分析栈模拟；结果与分析栈有关，不缓存
+// 所有路径都不能继续（输入有错误）时选第一个候选，之后由原来的错误恢复处理；
+// 有路径走完整个分析栈时（文法有二义性）选其中编号最小的候选
+// DFA缓存属于各个LLParser，多个线程共用LLAnalysis时不需要加锁
+// ============================================================
+class AdaptivePredictor {
+private:
+    // 模拟中的一条路径：所选的候选产生式和待匹配的符号（栈顶在末尾）
+    // LL模拟时符号用完后继续取分析栈parseStack[0, depth)中的符号
+    struct Config {
+        int alt;
+        size_t depth;
+        vector<int> stack;
+
+        bool operator<(const Config& other) const {
+            if (alt != other.alt) return alt < other.alt;
+            if (depth != other.depth) return depth < other.depth;
+            return stack < other.stack;
+        }
+    };
+
+    // DFA状态：SLL模拟读入若干token之后的路径集合（已排序、去重）
+    struct DfaState {
+        vector<Config> configs;
+        int prediction;             // 所有路径的候选相同时为该产生式，否则为-1
+        bool needsContext;          // 候选不唯一且有路径走完了当前非终结符，需要LL模拟
+        vector<int> edges;          // token种类 -> 下一个状态，UNKNOWN或DEAD
+    };
+
+    // 每个冲突表项的DFA，状态0是读入token之前的初始状态
+    struct Dfa {
+        vector<DfaState> states;
+        map<vector<Config>, int> index;     // 路径集合 -> 状态编号
+    };
+
+    enum {
+        UNKNOWN = -1,                       // 该token的转移尚未计算
+        DEAD = -2                           // 读入该token后没有路径能继续
+    };
+    static const size_t MAX_STACK = 256;    // 左递归会使展开无限进行，超过此深度的路径放弃
+
+    const Grammar& grammar;
+    const ParseTable& parseTable;
+    vector<Dfa> dfas;                       // 冲突编号 -> DFA
+
+    // 展开路径栈顶的非终结符，直到每条路径的栈顶都是终结符或者路径已走完
+    // context为nullptr时是SLL模拟，走完当前非终结符的路径到此为止；
+    // 否则是LL模拟，继续取分析栈中的符号（跳过结束标记），分析栈也用完的路径到此为止
+    vector<Config> closure(vector<Config> work, const vector<int>* context) const {
+        set<Config> visited, result;
+        while (!work.empty()) {
+            Config config = work.back();
+            work.pop_back();
+            if (!visited.insert(config).second) continue;
+
+            if (config.stack.empty()) {
+                while (context != nullptr && config.depth > 0 && (*context)[config.depth - 1] < 0) {
+                    config.depth--;
+                }
+                if (context == nullptr || config.depth == 0) {
+                    result.insert(config);
+                } else {
+                    config.stack.push_back((*context)[--config.depth]);
+                    work.push_back(config);
+                }
+                continue;
+            }
 
-    // 构造函数
-    TreeNode(const string& s) : symbol(s) {}
+            int top = config.stack.back();
+            if (!grammar.isNonTerminal(top)) {
+                result.insert(config);
+                continue;
+            }
+            config.stack.pop_back();
+            for (int p : grammar.productionsOf[top - TOKEN_KIND_COUNT]) {
+                const Production& production = grammar.productionList[p];
+                if (config.stack.size() + production.length > MAX_STACK) continue;
+                Config next = config;
+                for (int k = production.length - 1; k >= 0; k--) {
+                    next.stack.push_back(grammar.productionSymbols[production.begin + k]);
+                }
+                work.push_back(next);
+            }
+        }
+        return vector<Config>(result.begin(), result.end());
+    }
 
-    // 析构函数：递归释放所有子节点
-    ~TreeNode() {
-        for (auto child : children) {
-            delete child;
+    // 读入terminal：保留栈顶为该终结符的路径并弹出该终结符
+    static vector<Config> move(const vector<Config>& configs, int terminal) {
+        vector<Config> next;
+        for (const Config& config : configs) {
+            if (!config.stack.empty() && config.stack.back() == terminal) {
+                next.push_back(config);
+                next.back().stack.pop_back();
+            }
         }
+        return next;
     }
 
-    // 添加子节点
-    void addChild(TreeNode* child) {
-        children.push_back(child);
+    // 各候选产生式的初始路径
+    vector<Config> startConfigs(const vector<int>& alts, size_t depth) const {
+        vector<Config> configs;
+        for (int p : alts) {
+            const Production& production = grammar.productionList[p];
+            Config config;
+            config.alt = p;
+            config.depth = depth;
+            for (int k = production.length - 1; k >= 0; k--) {
+                config.stack.push_back(grammar.productionSymbols[production.begin + k]);
+            }
+            configs.push_back(config);
+        }
+        return configs;
     }
 
-    // 输出语法树（前序遍历，使用tab缩进）
-    // 参数：depth - 当前节点深度，用于控制缩进
-    void print(int depth = 0) const {
-        // 输出缩进：每层一个tab
-        for (int i = 0; i < depth; i++) {
-            cout << "\t";
+    // 冲突检查：路径按(depth, stack)分组，每组的候选集合都相同且不止一个时，这些候选此后
+    // 能走的路径完全相同，再向前看多少token也无法区分（真正的二义），返回其中编号最小的候选；
+    // 否则返回-1。configs按候选排序，每组中的候选也是从小到大
+    static int conflictAlt(const vector<Config>& configs) {
+        map<pair<size_t, vector<int>>, vector<int>> groups;
+        for (const Config& config : configs) {
+            groups[make_pair(config.depth, config.stack)].push_back(config.alt);
+        }
+        const vector<int>& alts = groups.begin()->second;
+        if (alts.size() < 2) return -1;
+        for (const auto& group : groups) {
+            if (group.second != alts) return -1;
         }
-        // 输出节点符号
-        cout << symbol << endl;
+        return alts[0];
+    }
 
-        // 递归输出所有子节点
-        for (const auto& child : children) {
-            child->print(depth + 1);
+    // 取得路径集合对应的DFA状态，没有时新建
+    int addState(Dfa& dfa, const vector<Config>& configs) {
+        auto found = dfa.index.find(configs);
+        if (found != dfa.index.end()) return found->second;
+
+        DfaState state;
+        state.configs = configs;
+        state.prediction = configs[0].alt;
+        state.needsContext = false;
+        for (const Config& config : configs) {
+            if (config.alt != state.prediction) state.prediction = -1;
+            if (config.stack.empty()) state.needsContext = true;
+        }
+        // SLL的路径栈是精确的，分组相同说明在任何上下文中都无法区分，直接缓存二义时的选择
+        if (state.prediction < 0) state.prediction = conflictAlt(configs);
+        if (state.prediction >= 0) state.needsContext = false;
+        state.edges.assign(TOKEN_KIND_COUNT, UNKNOWN);
+
+        dfa.states.push_back(state);
+        dfa.index[configs] = (int)dfa.states.size() - 1;
+        return (int)dfa.states.size() - 1;
+    }
+
+    // LL模拟：沿实际的分析栈从头模拟，不缓存
+    template <class Peek>
+    int predictWithContext(const vector<int>& alts, const vector<int>& parseStack, Peek& peek) const {
+        vector<Config> configs = closure(startConfigs(alts, parseStack.size()), &parseStack);
+        for (size_t i = 0;; i++) {
+            if (configs.empty()) return alts[0];
+            bool unique = true;
+            for (const Config& config : configs) {
+                if (config.alt != configs[0].alt) unique = false;
+            }
+            if (unique) return configs[0].alt;
+            // 二义时不必一直模拟到有路径走完整个分析栈（那样每次预测都要读完其后的输入）
+            int conflict = conflictAlt(configs);
+            if (conflict >= 0) return conflict;
+            // 路径按候选排序，第一条走完整个分析栈的路径即编号最小的候选
+            for (const Config& config : configs) {
+                if (config.stack.empty()) return config.alt;
+            }
+            configs = closure(move(configs, peek(i)), &parseStack);
+        }
+    }
+
+public:
+    AdaptivePredictor(const Grammar& g, const ParseTable& table)
+        : grammar(g), parseTable(table), dfas(table.conflicts.size()) {}
+
+    // 为冲突表项entry选出产生式
+    // 参数：parseStack - 分析栈，栈顶是当前非终结符的结束标记
+    //       peek - peek(i)返回当前token之后第i个token的种类，peek(0)是当前token
+    template <class Peek>
+    int predict(int entry, const vector<int>& parseStack, Peek peek) {
+        const vector<int>& alts = parseTable.candidates(entry);
+        Dfa& dfa = dfas[-2 - entry];
+        if (dfa.states.empty()) {
+            addState(dfa, closure(startConfigs(alts, 0), nullptr));
+        }
+
+        int s = 0;
+        for (size_t i = 0;; i++) {
+            if (dfa.states[s].prediction >= 0) return dfa.states[s].prediction;
+            if (dfa.states[s].needsContext) return predictWithContext(alts, parseStack, peek);
+
+            int terminal = peek(i);
+            int next = dfa.states[s].edges[terminal];
+            if (next == UNKNOWN) {
+                vector<Config> moved = closure(move(dfa.states[s].configs, terminal), nullptr);
+                next = moved.empty() ? DEAD : addState(dfa, moved);
+                dfa.states[s].edges[terminal] = next;
+            }
+            if (next == DEAD) return alts[0];
+            s = next;
         }
     }
 };
@@ -559,180 +1053,265 @@ public:
 // ============================================================
 // LLParser类：LL(1)语法分析器
 // 功能：
-//   1. 调用词法分析器获取token序列
-//   2. 使用LL(1)分析表进行语法分析
-//   3. 构建并输出语法树
+//   1. 分析过程中按需从词法分析器取得token
+//   2. 使用LL(1)分析表进行语法分析，把分析过程报告为事件
+//   3. 由TreeBuilder构建并输出语法树
 //   4. 支持错误检测和恢复
+// 文法和分析表在LLAnalysis中，可以自己构造或者与其他分析器共用；
+// 其余成员都是一次分析的状态，连续分析多个程序时复用各数组的容量
 // ============================================================
 class LLParser {
 private:
-    Grammar grammar;            // 文法定义
-    ParseTable parseTable;      // LL(1)分析表
-    vector<Token> tokens;       // token序列
-    size_t currentPos;          // 当前token位置
-    vector<string> errors;      // 错误信息列表
+    unique_ptr<LLAnalysis> ownedAnalysis;   // 自己构造的文法和分析表，共用时为空
+    const Grammar& grammar;                 // 文法定义
+    const ParseTable& parseTable;           // LL(1)分析表
+
+    // token由词法分析器按需产生：分析器只保存当前的向前看token和前一个token的行号，
+    // 不保存整个token序列，词法分析和语法分析在同一遍中交替进行
+    Lexer lexer;                // 当前输入的词法分析器
+    Token lookahead;            // 当前token（向前看符号）
+    vector<Token> peeked;       // 自适应预测多看的token，peeked[peekedPos]是lookahead的下一个
+    size_t peekedPos;
+    int prevTokenLine;          // 前一个token的行号，还没有前一个token时为-1
+    int errorCount;             // 已报告的错误数
     int lastErrorLine;          // 上次报错的行号，避免重复报错
+    ParseTree tree;             // 语法树，节点在下一次分析时整体释放
+    TreeBuilder builder;        // parse(prog)构建语法树使用的处理器
+
+    // 分析栈：非负数是待匹配的文法符号，负数~A表示非终结符A的子节点已全部产生
+    // 栈顶在末尾，多次分析时复用容量
+    vector<int> parseStack;
+
+    // 冲突表项的自适应预测，DFA缓存在各次分析之间保留
+    AdaptivePredictor predictor;
+
+    // 构造时使用的文法分析：自己构造的或者进程内共用的
+    const LLAnalysis& analysisOf(const GrammarFile& file) const {
+        return ownedAnalysis ? *ownedAnalysis : LLAnalysis::precomputed(file);
+    }
 
 public:
-    // 构造函数：初始化文法和分析表
-    LLParser() : parseTable(grammar), currentPos(0), lastErrorLine(-1) {}
+    // 构造函数：文法与静态数组相符时共用进程内唯一的LLAnalysis::precomputed()，
+    // 否则构造自己的文法和分析表
+    // 参数：file - 文法，默认为与实验三共用的C语言子集文法
+    //       cachePath - 分析缓存文件，见LLAnalysis
+    LLParser(const GrammarFile& file = cSubsetGrammar(), const string& cachePath = "")
+        : ownedAnalysis(file.hash == C_SUBSET_LL1_HASH ? nullptr : new LLAnalysis(file, cachePath)),
+          grammar(analysisOf(file).getGrammar()), parseTable(analysisOf(file).getParseTable()),
+          peekedPos(0), prevTokenLine(-1), errorCount(0), lastErrorLine(-1), tree(grammar), builder(tree),
+          predictor(grammar, parseTable) {}
+
+    // 构造函数：使用共用的文法和分析表，analysis须比本分析器存在得更久
+    explicit LLParser(const LLAnalysis& analysis)
+        : grammar(analysis.getGrammar()), parseTable(analysis.getParseTable()),
+          peekedPos(0), prevTokenLine(-1), errorCount(0), lastErrorLine(-1), tree(grammar), builder(tree),
+          predictor(grammar, parseTable) {}
 
     // 解析入口函数
     // 参数：prog - 输入的程序字符串
-    // 返回：语法树的根节点
-    TreeNode* parse(const string& prog) {
-        // 第一步：词法分析，获取token序列
-        Lexer lexer(prog);
-        tokens = lexer.tokenize();
-        currentPos = 0;
-        errors.clear();
-        lastErrorLine = -1;
+    // 返回：语法树，在下一次调用parse()之前有效
+    const ParseTree& parse(const string& prog) {
+        // 第一步：从输入开头开始词法分析，取得第一个token
+        start(prog);
 
-        // 第二步：语法分析，从起始符号program开始
-        TreeNode* root = parseNonTerminal("program");
+        // 释放上一棵树；token数事先未知，按输入长度估计：以空格分隔时token数不超过长度的一半，
+        // 无错误时节点数约为token数的3倍
+        builder.reset();
+        tree.reserve(prog.size() * 3 / 2 + 1);
+
+        // 第二步：语法分析，从起始符号（program）开始，边取token边分析，由TreeBuilder构建语法树
+        parseTokens(builder);
 
         // 第三步：输出错误信息（在语法树之前）
-        for (const auto& err : errors) {
+        for (const auto& err : builder.errors) {
             cout << err << endl;
         }
 
-        return root;
+        return tree;
+    }
+
+    // 事件模式：分析prog，把分析过程依次报告给handler，不构建语法树
+    // 错误恢复与parse(prog)完全相同，handler收到的事件可以还原出同一棵语法树
+    template <class Handler>
+    void parse(const string& prog, Handler& handler) {
+        start(prog);
+        parseTokens(handler);
+    }
+
+    // 文法，供事件处理器取得符号名
+    const Grammar& getGrammar() const {
+        return grammar;
     }
 
 private:
     // 获取当前待处理的token
     Token& currentToken() {
-        return tokens[currentPos];
+        return lookahead;
     }
 
     // 获取前一个token的行号（用于错误报告）
     // 因为缺少的符号应该出现在前一个token之后
     int getPrevTokenLine() {
-        if (currentPos > 0) {
-            return tokens[currentPos - 1].line;
+        if (prevTokenLine >= 0) {
+            return prevTokenLine;
         }
-        return tokens[currentPos].line;
+        return lookahead.line;
     }
 
-    // 前进到下一个token
+    // 前进到下一个token，到达$后不再前进
     void advance() {
-        if (currentPos < tokens.size() - 1) {
-            currentPos++;
+        if (lookahead.kind != TK_END) {
+            prevTokenLine = lookahead.line;
+            if (peekedPos < peeked.size()) {
+                lookahead = peeked[peekedPos++];
+            } else {
+                lexer.next(lookahead);
+            }
         }
     }
 
-    // 递归下降解析非终结符
-    // 参数：nonTerminal - 要解析的非终结符
-    // 返回：对应的语法树节点
-    TreeNode* parseNonTerminal(const string& nonTerminal) {
-        // 创建当前非终结符的节点
-        TreeNode* node = new TreeNode(nonTerminal);
-
-        // 获取当前输入符号（向前看符号）
-        string lookahead = currentToken().type;
-
-        // 在分析表中查找对应的产生式
-        if (!parseTable.hasEntry(nonTerminal, lookahead)) {
-            // 分析表中无对应项，进行错误处理
-            handleError(nonTerminal, lookahead, node);
-            return node;
+    // 当前token之后的第i个token（i为0时是当前token），只在自适应预测时使用
+    const Token& peekToken(size_t i) {
+        if (i == 0) return lookahead;
+        if (peekedPos == peeked.size()) {
+            peeked.clear();
+            peekedPos = 0;
+        }
+        while (peeked.size() - peekedPos < i) {
+            peeked.push_back(Token());
+            lexer.next(peeked.back());
         }
+        return peeked[peekedPos + i - 1];
+    }
 
-        // 获取要使用的产生式
-        vector<string> production = parseTable.getProduction(nonTerminal, lookahead);
+    // 开始分析prog：重置词法分析器和分析状态，读入第一个token
+    void start(const string& prog) {
+        lexer.reset(prog);
+        lexer.next(lookahead);
+        peeked.clear();
+        peekedPos = 0;
+        prevTokenLine = -1;
+        errorCount = 0;
+        lastErrorLine = -1;
+    }
 
-        // 处理空产生式（E表示epsilon）
-        if (production.size() == 1 && production[0] == "E") {
-            node->addChild(new TreeNode("E"));
-            return node;
+    // 表驱动的预测分析：用显式的符号栈代替递归，分析深度不受调用栈限制
+    // 非终结符出栈时报告onEnter并展开，其产生式体之下压入结束标记~A，
+    // 结束标记出栈时报告onExit，事件的顺序与递归下降的前序相同
+    template <class Handler>
+    void parseTokens(Handler& handler) {
+        parseStack.clear();
+        handler.onEnter(grammar.startId);
+        parseStack.push_back(~grammar.startId);
+        expand(grammar.startId, handler);
+
+        while (!parseStack.empty()) {
+            int symbol = parseStack.back();
+            parseStack.pop_back();
+
+            if (symbol < 0) {
+                // 结束标记：该非终结符的子节点都已产生
+                handler.onExit(~symbol);
+            } else if (grammar.isNonTerminal(symbol)) {
+                // 非终结符：报告开始，压入结束标记后按分析表展开
+                handler.onEnter(symbol);
+                parseStack.push_back(~symbol);
+                expand(symbol, handler);
+            } else if (currentToken().kind == symbol) {
+                // 终结符匹配成功，报告该token并前进
+                handler.onToken(symbol, &currentToken());
+                advance();
+            } else {
+                // 匹配失败：缺少终结符，进行错误处理
+                handleMissingTerminal(symbol, handler);
+            }
         }
+    }
 
-        // 按顺序处理产生式中的每个符号
-        for (const auto& symbol : production) {
-            if (grammar.nonTerminals.count(symbol)) {
-                // 符号是非终结符：递归解析
-                TreeNode* child = parseNonTerminal(symbol);
-                node->addChild(child);
-            } else {
-                // 符号是终结符：尝试匹配
-                if (currentToken().type == symbol) {
-                    // 匹配成功，添加终结符节点并前进
-                    node->addChild(new TreeNode(symbol));
-                    advance();
-                } else {
-                    // 匹配失败：缺少终结符，进行错误处理
-                    handleMissingTerminal(symbol, node);
+    // 按当前向前看符号选择nonTerminal的产生式，把产生式体逆序压栈
+    // 参数：nonTerminal - 要展开的非终结符编号，其结束标记已在栈顶
+    template <class Handler>
+    void expand(int nonTerminal, Handler& handler) {
+        // 策略4跳过token后重新查表，直到选出产生式或以其他策略恢复
+        for (;;) {
+            // 获取当前输入符号（向前看符号），token种类即终结符编号
+            int lookahead = currentToken().kind;
+
+            // 在分析表中查找对应的产生式
+            int p = parseTable.lookup(nonTerminal, lookahead);
+            if (p < 0) {
+                if (p == -1) {
+                    // 分析表中无对应项，进行错误处理
+                    if (!handleError(nonTerminal, lookahead, handler)) {
+                        return;
+                    }
+                    continue;
                 }
+                // 冲突表项：向前多看几个token选出产生式
+                p = predictor.predict(p, parseStack, [this](size_t i) { return peekToken(i).kind; });
             }
-        }
 
-        return node;
+            // 获取要使用的产生式
+            const Production& production = grammar.productionList[p];
+
+            // 处理空产生式（产生式体为空）
+            if (production.length == 0) {
+                handler.onToken(grammar.epsilonId, nullptr);
+                return;
+            }
+
+            // 逆序压栈，使产生式的第一个符号位于栈顶
+            const int* body = &grammar.productionSymbols[production.begin];
+            for (int k = production.length - 1; k >= 0; k--) {
+                parseStack.push_back(body[k]);
+            }
+            return;
+        }
     }
 
     // 处理缺少终结符的错误（插入恢复策略）
-    // 参数：expected - 期望的终结符
-    //       parent - 父节点，用于添加恢复的节点
-    void handleMissingTerminal(const string& expected, TreeNode* parent) {
+    // 参数：expected - 期望的终结符编号
+    template <class Handler>
+    void handleMissingTerminal(int expected, Handler& handler) {
+        const string& name = grammar.symbolName(expected);
+
         // 使用前一个token的行号报错
         int line = getPrevTokenLine();
 
         // 避免在同一行重复报错
-        if (line != lastErrorLine || errors.empty()) {
+        if (line != lastErrorLine || errorCount == 0) {
             // 生成错误信息，格式：语法错误,第X行,缺少"Y"
-            string errorMsg = "语法错误,第" + to_string(line) + "行,缺少\"" + expected + "\"";
-            errors.push_back(errorMsg);
+            handler.onError("语法错误,第" + to_string(line) + "行,缺少\"" + name + "\"");
+            errorCount++;
             lastErrorLine = line;
         }
 
-        // 错误恢复：插入缺失的终结符节点
+        // 错误恢复：插入缺失的终结符
         // 这样可以继续解析后续内容
-        parent->addChild(new TreeNode(expected));
+        handler.onToken(expected, nullptr);
     }
 
     // 处理分析表无对应项的错误（同步恢复策略）
-    // 参数：nonTerminal - 当前要解析的非终结符
-    //       lookahead - 当前输入符号
-    //       node - 当前节点
-    void handleError(const string& nonTerminal, const string& lookahead, TreeNode* node) {
-        // 策略1：如果当前输入在FOLLOW集合中，使用空产生式恢复
-        // 这意味着该非终结符推导为空，继续解析后续部分
-        if (grammar.followSets[nonTerminal].count(lookahead)) {
-            node->addChild(new TreeNode("E"));
-            return;
+    // 参数：nonTerminal - 当前要解析的非终结符编号
+    //       lookahead - 当前输入符号的编号
+    // 返回：是否需要用新的向前看符号重新展开该非终结符
+    template <class Handler>
+    bool handleError(int nonTerminal, int lookahead, Handler& handler) {
+        // 策略1～3：当前输入在FOLLOW集合中、stmts遇到}、或该非终结符可以为空，
+        // 使用空产生式恢复，继续解析后续部分；这些情况已在分析表构建时合并为一个集合
+        if (parseTable.recoversWithEpsilon(nonTerminal, lookahead)) {
+            handler.onToken(grammar.epsilonId, nullptr);
+            return false;
         }
 
-        // 策略2：对于stmts遇到}，说明语句序列结束
-        if (nonTerminal == "stmts" && lookahead == "}") {
-            node->addChild(new TreeNode("E"));
-            return;
-        }
+        // 策略4：跳过token，直到遇到同步集合中的符号或输入结束
+        // 每个token只被检查一次，恢复时间与跳过的token数成正比
+        do {
+            advance();
+        } while (currentToken().kind != TK_END && !parseTable.isSync(nonTerminal, currentToken().kind));
 
-        // 策略3：检查该非终结符是否可以为空
-        bool canBeEmpty = false;
-        for (const auto& prod : grammar.productions[nonTerminal]) {
-            if (prod.size() == 1 && prod[0] == "E") {
-                canBeEmpty = true;
-                break;
-            }
-        }
-        if (canBeEmpty) {
-            node->addChild(new TreeNode("E"));
-            return;
-        }
-
-        // 策略4：跳过当前token，重新尝试解析
-        advance();
-
-        // 重新尝试解析当前非终结符
-        if (currentPos < tokens.size() - 1) {
-            TreeNode* retry = parseNonTerminal(nonTerminal);
-            // 将重试得到的子节点转移到当前节点
-            for (auto child : retry->children) {
-                node->addChild(child);
-            }
-            retry->children.clear();
-            delete retry;
-        }
+        // 重新尝试解析当前非终结符，得到的子节点仍属于当前非终结符
+        return currentToken().kind != TK_END;
     }
 };
 
@@ -747,17 +1326,15 @@ void Analysis()
 
     /********* Begin *********/
 
-    // 创建LL(1)语法分析器实例
-    LLParser parser;
+    // 创建LL(1)语法分析器实例：分析表直接使用编译进程序的静态数组；
+    // 修改了c_subset.bnf而未重新生成静态数组时，改用可执行文件旁边的分析缓存
+    LLParser parser(cSubsetGrammar(), defaultCachePath());
 
     // 解析程序，构建语法树
-    TreeNode* root = parser.parse(prog);
+    const ParseTree& tree = parser.parse(prog);
 
     // 输出语法树（使用tab缩进表示层级）
-    if (root) {
-        root->print();
-        delete root;  // 释放内存
-    }
+    tree.print();
 
     /********* End *********/
 }
@@ -0,0 +1,158 @@
+// 自适应预测测试程序
+// 测试非LL(1)文法的冲突表项：需要向前看任意多个token的选择、需要分析栈才能决定的选择、
+// 二义性和错误输入的处理，以及冲突表项经分析缓存恢复后结果不变
+
+#include "../LLparser.h"
+#include "../../common/test_util.h"
+#include <chrono>
+
+// 非LL(1)文法：stmt遇到ID或(时有多个候选，lhs可以任意层嵌套括号，
+// 只有读到括号之后的=或;才能确定；assg遇到ID时要看assg之后的符号
+const char* grammarText = R"BNF(
+program -> compoundstmt
+compoundstmt -> { stmts }
+stmts -> stmt stmts | E
+stmt -> lhs = NUM ; | lhs ; | ID ( ) ; | assg ;
+lhs -> ID | ( lhs )
+assg -> ID | ID = ID
+)BNF";
+
+// 二义文法：x的两个候选都能分析连续的ID ;，SLL模拟看不出来，要沿分析栈模拟到
+// 两个候选的路径汇合为止
+const char* ambiguousText = R"BNF(
+program -> compoundstmt
+compoundstmt -> { stmts }
+stmts -> stmt stmts | E
+stmt -> x
+x -> ID ; | ID ; ID ;
+)BNF";
+
+/* 去掉语法树输出中的缩进和换行，只保留符号序列，便于与期望值比较 */
+string flatten(const string& output) {
+    string result;
+    istringstream in(output);
+    string line;
+    while (getline(in, line)) {
+        size_t start = line.find_first_not_of('\t');
+        if (start == string::npos) continue;
+        result += (result.empty() ? "" : " ") + line.substr(start);
+    }
+    return result;
+}
+
+void testTable(const GrammarFile& file) {
+    cout << "\n=== 冲突表项 ===" << endl;
+    LLAnalysis builtin;
+    check(builtin.getParseTable().conflicts.empty(), "内置的C语言子集文法没有冲突表项");
+
+    LLAnalysis analysis(file);
+    const Grammar& grammar = analysis.getGrammar();
+    const ParseTable& table = analysis.getParseTable();
+    int stmt = grammar.symbolIds.at("stmt");
+    int entry = table.lookup(stmt, TK_ID);
+    check(entry < -1 && table.candidates(entry).size() == 4, "stmt遇到ID时有4个候选产生式");
+    entry = table.lookup(stmt, TK_LPAREN);
+    check(entry < -1 && table.candidates(entry).size() == 2, "stmt遇到(时有2个候选产生式");
+    check(table.lookup(stmt, TK_NUM) == -1, "无对应项的表项不受影响");
+}
+
+void testPrediction(const GrammarFile& file) {
+    cout << "\n=== 自适应预测 ===" << endl;
+    LLParser parser(file);
+
+    string output = parseAndPrint(parser, "{\n( ( ( ID ) ) ) = NUM ;\n( ID ) ;\n}");
+    check(flatten(output) ==
+          "program compoundstmt { stmts stmt lhs ( lhs ( lhs ( lhs ID ) ) ) = NUM ; "
+          "stmts stmt lhs ( lhs ID ) ; stmts E }",
+          "括号嵌套任意层时读到其后的=或;才选择");
+
+    output = parseAndPrint(parser, "{\nID ( ) ;\nID = ID ;\n}");
+    check(flatten(output) ==
+          "program compoundstmt { stmts stmt ID ( ) ; stmts stmt assg ID = ID ; stmts E }",
+          "assg的选择由分析栈中其后的;决定");
+
+    output = parseAndPrint(parser, "{\nID ;\n}");
+    check(flatten(output) == "program compoundstmt { stmts stmt lhs ID ; stmts E }",
+          "二义时选择编号最小的候选（lhs ;而不是assg ;）");
+
+    output = parseAndPrint(parser, "{\nID = ;\n}");
+    check(output.compare(0, strlen("语法错误"), "语法错误") == 0 &&
+          output.find("program") != string::npos, "错误输入选第一个候选并按原来的方式恢复");
+
+    // DFA缓存在各次分析之间保留，重复分析与新的分析器结果相同
+    string prog = "{\n( ID ) = NUM ;\nID ;\nID = ID ;\n( ( ID ) ) ;\n}";
+    string first = parseAndPrint(parser, prog);
+    string second = parseAndPrint(parser, prog);
+    LLParser fresh(file);
+    check(first == second && first == parseAndPrint(fresh, prog), "使用DFA缓存的结果与首次预测相同");
+}
+
+/* 分析count条"ID ;"语句，返回3次中最短的平均每条语句耗时（微秒） */
+double timePerStatement(LLParser& parser, int count) {
+    string prog = "{\n";
+    for (int i = 0; i < count; i++) {
+        prog += "ID ;\n";
+    }
+    prog += "}";
+    double best = -1;
+    for (int r = 0; r < 3; r++) {
+        SyntaxChecker checker;
+        auto start = chrono::steady_clock::now();
+        parser.parse(prog, checker);
+        double us = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count() / count;
+        if (best < 0 || us < best) best = us;
+    }
+    return best;
+}
+
+void testScaling(const GrammarFile& file, const GrammarFile& ambiguous) {
+    cout << "\n=== 二义输入的分析时间 ===" << endl;
+    LLParser sll(file);
+    LLParser ll(ambiguous);
+    check(flatten(parseAndPrint(ll, "{\nID ;\nID ;\n}")) ==
+          "program compoundstmt { stmts stmt x ID ; stmts stmt x ID ; stmts E }",
+          "路径汇合后选择编号最小的候选（两个x -> ID ;）");
+
+    // 每次预测只向前看到二义出现为止：语句数变为4倍时每条语句的耗时基本不变，
+    // 每次都模拟到输入末尾时会变为约4倍
+    double sllSmall = timePerStatement(sll, 500), sllLarge = timePerStatement(sll, 2000);
+    double llSmall = timePerStatement(ll, 500), llLarge = timePerStatement(ll, 2000);
+    cout << "SLL二义: " << sllSmall << " -> " << sllLarge << " 微秒/语句" << endl;
+    cout << "LL二义:  " << llSmall << " -> " << llLarge << " 微秒/语句" << endl;
+    check(sllLarge < sllSmall * 2 + 0.5, "SLL模拟中的二义：耗时随语句数线性增长");
+    check(llLarge < llSmall * 2 + 0.5, "沿分析栈模拟的二义：耗时随语句数线性增长");
+}
+
+void testCache(const GrammarFile& file) {
+    cout << "\n=== 分析缓存 ===" << endl;
+    const char* path = "adaptive_test.cache";
+    remove(path);
+    string prog = "{\n( ( ID ) ) = NUM ;\nID = ID ;\nID ( ) ;\n}";
+    LLParser computed(file, path);
+    string expected = parseAndPrint(computed, prog);
+    LLParser restored(file, path);
+    LLAnalysis analysis(file, path);
+    check(parseAndPrint(restored, prog) == expected &&
+          analysis.getParseTable().conflicts == LLAnalysis(file).getParseTable().conflicts,
+          "从缓存恢复的冲突表项与重新计算的相同");
+    remove(path);
+}
+
+int main() {
+    GrammarFile file;
+    if (!file.parse(grammarText)) {
+        cout << file.error << endl;
+        return 1;
+    }
+    GrammarFile ambiguous;
+    if (!ambiguous.parse(ambiguousText)) {
+        cout << ambiguous.error << endl;
+        return 1;
+    }
+    testTable(file);
+    testPrediction(file);
+    testScaling(file, ambiguous);
+    testCache(file);
+
+    return testSummary();
+}
@@ -0,0 +1,100 @@
+// ============================================================
+// 批量输入
+// 功能：依次给出一批程序，来源可以是
+//   1. 一个目录：目录中的每个普通文件是一个程序，按文件名排序
+//   2. 一个流：程序之间用单独一行的"%%"分隔
+// 当前程序放在prog中，各程序共用同一个缓冲区，容量足够后读入不再分配内存
+// ============================================================
+#ifndef BATCH_INPUT_H
+#define BATCH_INPUT_H
+
+#include "../LLparser.h"
+#include <dirent.h>
+#include <sys/stat.h>
+
+class BatchInput {
+private:
+    vector<string> files;       // 目录模式：文件路径，按名称排序
+    size_t nextFile;
+    istream* stream;            // 流模式的输入，目录模式为nullptr
+    string line;                // 流模式的行缓冲
+    int count;                  // 已给出的程序数
+
+    bool readFile(const string& path) {
+        ifstream in(path.c_str(), ios::binary);
+        if (!in) return false;
+        in.seekg(0, ios::end);
+        streamoff size = in.tellg();
+        in.seekg(0, ios::beg);
+        prog.resize((size_t)size);
+        if (size > 0) in.read(&prog[0], size);
+        return (bool)in;
+    }
+
+    // 读到分隔行或流结束；流已结束且没有读到任何行时返回false
+    bool readDelimited() {
+        prog.clear();
+        bool any = false;
+        while (getline(*stream, line)) {
+            if (!line.empty() && line[line.size() - 1] == '\r') line.erase(line.size() - 1);
+            if (line == "%%") return true;
+            prog += line;
+            prog += '\n';
+            any = true;
+        }
+        return any;
+    }
+
+public:
+    string name;                // 当前程序的名称：文件路径，或流中的序号
+    string prog;                // 当前程序的内容
+
+    BatchInput() : nextFile(0), stream(nullptr), count(0) {}
+
+    // 以目录中的文件为输入，目录无法打开时返回false
+    bool openDirectory(const string& dir) {
+        DIR* d = opendir(dir.c_str());
+        if (d == nullptr) return false;
+        files.clear();
+        while (dirent* entry = readdir(d)) {
+            string path = dir + "/" + entry->d_name;
+            struct stat st;
+            if (entry->d_name[0] != '.' && stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode)) {
+                files.push_back(path);
+            }
+        }
+        closedir(d);
+        sort(files.begin(), files.end());
+        nextFile = 0;
+        stream = nullptr;
+        count = 0;
+        return true;
+    }
+
+    // 以"%%"行分隔的流为输入
+    void openStream(istream& in) {
+        files.clear();
+        stream = &in;
+        count = 0;
+    }
+
+    // 读入下一个程序，没有更多程序时返回false；无法读取的文件被跳过并报告到cerr
+    bool next() {
+        if (stream != nullptr) {
+            if (!readDelimited()) return false;
+            name = "#" + to_string(++count);
+            return true;
+        }
+        while (nextFile < files.size()) {
+            name = files[nextFile++];
+            if (readFile(name)) {
+                count++;
+                return true;
+            }
+            cerr << "无法读取: " << name << endl;
+        }
+        return false;
+    }
+};
+
+#endif
@@ -0,0 +1,51 @@
+// 批量语法分析程序
+// 用一个LLParser依次分析一批程序，文法和分析表只准备一次，各次分析复用缓冲区
+// 用法：./batch_parser [-q] 目录      分析目录中的每个文件
+//       ./batch_parser [-q] -         分析标准输入中以"%%"行分隔的各个程序
+// 默认对每个程序输出"=== 名称 ==="和与main.cpp相同的错误信息、语法树；
+// -q只输出每个程序的错误数。最后在cerr输出程序数和耗时
+
+#include "BatchInput.h"
+#include <chrono>
+
+int main(int argc, char* argv[]) {
+    bool quiet = argc > 1 && string(argv[1]) == "-q";
+    int first = quiet ? 2 : 1;
+    if (argc != first + 1) {
+        cerr << "用法: " << argv[0] << " [-q] 目录|-" << endl;
+        return 2;
+    }
+
+    BatchInput input;
+    string source = argv[first];
+    if (source == "-") {
+        input.openStream(cin);
+    } else if (!input.openDirectory(source)) {
+        cerr << "无法打开目录: " << source << endl;
+        return 1;
+    }
+
+    LLParser parser;
+    SyntaxChecker checker;
+    int programs = 0, withErrors = 0;
+    auto start = chrono::steady_clock::now();
+    while (input.next()) {
+        programs++;
+        if (quiet) {
+            checker.errors.clear();
+            parser.parse(input.prog, checker);
+            withErrors += !checker.errors.empty();
+            cout << input.name << ": " << checker.errors.size() << "个错误" << endl;
+        } else {
+            cout << "=== " << input.name << " ===" << endl;
+            parser.parse(input.prog).print();
+        }
+    }
+    auto end = chrono::steady_clock::now();
+
+    double seconds = chrono::duration<double>(end - start).count();
+    cerr << programs << "个程序";
+    if (quiet) cerr << "，" << withErrors << "个有错误";
+    cerr << "，用时" << seconds << "秒" << endl;
+    return 0;
+}
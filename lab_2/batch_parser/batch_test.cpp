@@ -0,0 +1,137 @@
+// 批量分析测试程序
+// 测试BatchInput对目录和分隔流的切分、共用LLAnalysis的多个分析器与独立分析器的输出相同，
+// 以及缓冲区容量足够后连续分析不再分配内存
+
+#include "BatchInput.h"
+#include "../../common/test_util.h"
+#include <cstdlib>
+#include <new>
+
+// 统计operator new的调用次数
+// noinline：避免编译器把内联后的malloc/free误报为与new/delete不匹配
+static long allocations = 0;
+
+__attribute__((noinline)) void* operator new(size_t size) {
+    allocations++;
+    void* p = malloc(size == 0 ? 1 : size);
+    if (p == nullptr) throw bad_alloc();
+    return p;
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept {
+    free(p);
+}
+
+// C++14起delete可能调用带大小的版本，同样交给free()
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+const char* programs[] = {
+    "{\nID = NUM ;\n}",
+    "{\nwhile ( ID == NUM )\n{\nID = ID + NUM * ( ID - NUM ) ;\n}\n}",
+    "{\nID = NUM\n}",
+    "",
+    "{\nif ( ID > NUM ) ID = NUM ; else ID = NUM ;\n}"
+};
+const size_t programCount = sizeof(programs) / sizeof(programs[0]);
+
+void testBatchInput() {
+    cout << "\n=== BatchInput ===" << endl;
+    BatchInput input;
+    istringstream stream("{ x = 1 ; }\n%%\n\n%%\r\n{\n}\n");
+    input.openStream(stream);
+    vector<string> progs, names;
+    while (input.next()) {
+        progs.push_back(input.prog);
+        names.push_back(input.name);
+    }
+    check(progs.size() == 3 && progs[0] == "{ x = 1 ; }\n" && progs[1] == "\n" && progs[2] == "{\n}\n",
+          "按%%行切分流（含CRLF和空程序）");
+    check(names.size() == 3 && names[2] == "#3", "流中的程序按序号命名");
+
+    istringstream trailing("{ }\n%%\n");
+    input.openStream(trailing);
+    int count = 0;
+    while (input.next()) count++;
+    check(count == 1, "最后一个分隔行之后没有程序");
+
+    mkdir("batch_dir", 0755);
+    writeFile("batch_dir/b.txt", programs[1]);
+    writeFile("batch_dir/a.txt", programs[0]);
+    writeFile("batch_dir/.hidden", "ignored");
+    check(input.openDirectory("batch_dir"), "打开目录");
+    names.clear();
+    progs.clear();
+    while (input.next()) {
+        names.push_back(input.name);
+        progs.push_back(input.prog);
+    }
+    check(names.size() == 2 && names[0] == "batch_dir/a.txt" && progs[1] == programs[1],
+          "目录中的文件按名称排序，跳过隐藏文件");
+    remove("batch_dir/a.txt");
+    remove("batch_dir/b.txt");
+    remove("batch_dir/.hidden");
+    rmdir("batch_dir");
+    check(!input.openDirectory("batch_dir"), "目录不存在");
+}
+
+void testSharedAnalysis() {
+    cout << "\n=== 共用文法和分析表 ===" << endl;
+    LLAnalysis analysis;
+    LLParser first(analysis), second(analysis);
+    bool same = true;
+    for (size_t i = 0; i < programCount; i++) {
+        LLParser fresh;
+        string expected = parseAndPrint(fresh, programs[i]);
+        same = same && parseAndPrint(first, programs[i]) == expected &&
+               parseAndPrint(second, programs[programCount - 1 - i]) ==
+               parseAndPrint(fresh, programs[programCount - 1 - i]);
+    }
+    check(same, "共用LLAnalysis的分析器与独立的分析器输出相同");
+
+    // 同一个分析器连续分析，前一次的错误和语法树不影响后一次
+    LLParser parser(analysis);
+    string errorOutput = parseAndPrint(parser, programs[2]);
+    string cleanOutput = parseAndPrint(parser, programs[0]);
+    LLParser fresh;
+    check(errorOutput == parseAndPrint(fresh, programs[2]) && cleanOutput == parseAndPrint(fresh, programs[0]),
+          "连续分析互不影响");
+}
+
+void testNoAllocation() {
+    cout << "\n=== 缓冲区复用 ===" << endl;
+    LLParser parser;
+    string large = "{\n";
+    for (int i = 0; i < 100; i++) {
+        large += "while ( ID < NUM ) { ID = ( ID + NUM ) * ID ; }\n";
+    }
+    large += "}";
+    string small = programs[1], clean = programs[0];
+
+    // 先分析一次最大的程序，使各缓冲区达到所需容量
+    parser.parse(large);
+    SyntaxChecker checker;
+    parser.parse(large, checker);
+
+    long before = allocations;
+    parser.parse(large);
+    parser.parse(small);
+    // 先取得结果再调用check()，其参数中的字符串也会分配内存
+    bool none = allocations == before;
+    check(none, "parse(prog)不再分配内存");
+
+    before = allocations;
+    parser.parse(large, checker);
+    parser.parse(clean, checker);
+    none = allocations == before;
+    check(none, "事件模式不再分配内存");
+}
+
+int main() {
+    testBatchInput();
+    testSharedAnalysis();
+    testNoAllocation();
+
+    return testSummary();
+}
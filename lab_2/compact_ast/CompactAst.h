@@ -0,0 +1,263 @@
+// ============================================================
+// 紧凑抽象语法树
+// 功能：在分析过程中（作为LLParser的事件处理器）直接构建只含语句、二元表达式和
+//       叶子的抽象语法树，不再保留stmts、arithexprprime、boolop等辅助非终结符和E节点
+// 存储：所有节点按后序连续存放在一个数组中，子树[id - size + 1, id]是连续的一段，
+//       最后一个子节点是id - 1，子节点c的前一个兄弟是c - nodes[c].size
+// 用法：
+//   CompactAst ast;
+//   AstBuilder builder(parser.getGrammar(), ast);
+//   parser.parse(prog, builder);
+// ============================================================
+#ifndef COMPACT_AST_H
+#define COMPACT_AST_H
+
+#include "../LLparser.h"
+
+// 节点种类
+enum AstKind {
+    AST_BLOCK,      // 复合语句，子节点为各语句
+    AST_IF,         // if语句：条件、then分支、else分支
+    AST_WHILE,      // while语句：条件、循环体
+    AST_ASSIGN,     // 赋值语句：左部标识符、右部表达式
+    AST_BINARY,     // 二元表达式（算术或比较）：左操作数、右操作数
+    AST_ID,         // 标识符
+    AST_NUM,        // 数字
+    AST_ERROR       // 错误恢复后缺失的语句或表达式
+};
+
+// 16字节的节点
+struct AstNode {
+    uint8_t kind;       // AstKind
+    uint8_t op;         // AST_BINARY：运算符的TokenKind，比较运算符缺失时为TK_END
+    uint32_t size;      // 以本节点为根的子树的节点数（含本节点）
+    uint32_t count;     // 内部节点：子节点数；叶子：token长度
+    uint32_t offset;    // 叶子：token在源程序中的偏移
+};
+
+// ============================================================
+// CompactAst类：后序存放的抽象语法树
+// ============================================================
+class CompactAst {
+public:
+    vector<AstNode> nodes;      // 后序排列，最后一个节点是根
+
+    void clear() {
+        nodes.clear();
+    }
+
+    // 根节点，-1表示空树
+    int root() const {
+        return (int)nodes.size() - 1;
+    }
+
+    // 最后一个子节点，没有子节点时返回-1
+    int lastChild(int id) const {
+        return nodes[id].size > 1 ? id - 1 : -1;
+    }
+
+    // 前一个兄弟节点；first为父节点子树的第一个位置，越过时返回-1
+    int prevSibling(int child, int parent) const {
+        int prev = child - (int)nodes[child].size;
+        return prev > parent - (int)nodes[parent].size ? prev : -1;
+    }
+
+    // 以S表达式形式输出整棵树，如(block (assign x (+ a b)))
+    // 按后序依次处理节点，用字符串栈合并子节点，不递归
+    string toString(const string& prog) const {
+        vector<string> parts;
+        for (const AstNode& node : nodes) {
+            string text;
+            switch (node.kind) {
+            case AST_ID:
+            case AST_NUM:
+                parts.push_back(prog.substr(node.offset, node.count));
+                continue;
+            case AST_ERROR:
+                parts.push_back("<error>");
+                continue;
+            case AST_BLOCK:  text = "(block"; break;
+            case AST_IF:     text = "(if"; break;
+            case AST_WHILE:  text = "(while"; break;
+            case AST_ASSIGN: text = "(assign"; break;
+            default:
+                text = "(" + (node.op == TK_END ? string("?") : tokenKindName(node.op));
+                break;
+            }
+            for (size_t k = parts.size() - node.count; k < parts.size(); k++) {
+                text += " " + parts[k];
+            }
+            parts.resize(parts.size() - node.count);
+            parts.push_back(text + ")");
+        }
+        return parts.empty() ? "" : parts.back();
+    }
+};
+
+// ============================================================
+// AstBuilder：由分析事件构建CompactAst的处理器
+// 原理：
+//   1. 每个语句或表达式非终结符结束时恰好留下一棵子树，子树的根记录在roots栈中
+//   2. 语句节点在其非终结符结束时按已留下的子树个数生成，子节点已在它之前
+//   3. arithexprprime/multexprprime中的右操作数结束时，与前面的左操作数合并为
+//      二元表达式，得到左结合的表达式树
+//   4. 错误恢复使某个非终结符什么都没有留下时，补一个AST_ERROR叶子，树的形状始终完整
+// ============================================================
+class AstBuilder {
+private:
+    // 非终结符在构建中的作用
+    enum Role {
+        ROLE_NONE,          // stmts：不产生节点
+        ROLE_PASS,          // program、stmt、arithexpr、multexpr、simpleexpr：留下子节点的子树
+        ROLE_BLOCK,         // compoundstmt
+        ROLE_IF,            // ifstmt
+        ROLE_WHILE,         // whilestmt
+        ROLE_ASSIGN,        // assgstmt
+        ROLE_COMPARE,       // boolexpr
+        ROLE_OPERATOR,      // boolop：运算符交给boolexpr
+        ROLE_TAIL           // arithexprprime、multexprprime：运算符和右操作数
+    };
+
+    // 一个尚未结束的非终结符
+    struct Frame {
+        uint8_t role;
+        bool matched;       // 是否选中了产生式（出现过非E的子节点）
+        int op;             // ROLE_COMPARE、ROLE_TAIL：运算符
+        size_t mark;        // 开始时roots的大小
+    };
+
+    CompactAst& ast;
+    vector<uint8_t> roles;      // 符号编号 -> Role
+    vector<Frame> frames;
+    vector<int> roots;          // 已完成、尚未成为子节点的子树根
+
+    void setRole(const Grammar& grammar, const char* name, Role role) {
+        auto it = grammar.symbolIds.find(name);
+        if (it != grammar.symbolIds.end()) roles[it->second] = role;
+    }
+
+    static uint8_t nodeKind(uint8_t role) {
+        switch (role) {
+        case ROLE_IF:     return AST_IF;
+        case ROLE_WHILE:  return AST_WHILE;
+        case ROLE_ASSIGN: return AST_ASSIGN;
+        default:          return AST_BINARY;
+        }
+    }
+
+    void emitLeaf(uint8_t kind, const Token* token) {
+        AstNode node = {kind, 0, 1, 0, 0};
+        if (token != nullptr) {
+            node.count = (uint32_t)token->length;
+            node.offset = (uint32_t)token->offset;
+        }
+        roots.push_back((int)ast.nodes.size());
+        ast.nodes.push_back(node);
+    }
+
+    // 以roots栈顶的count棵子树为子节点生成内部节点
+    void emitNode(uint8_t kind, size_t count, int op) {
+        uint32_t size = 1;
+        for (size_t k = roots.size() - count; k < roots.size(); k++) {
+            size += ast.nodes[roots[k]].size;
+        }
+        roots.resize(roots.size() - count);
+        AstNode node = {kind, (uint8_t)op, size, (uint32_t)count, 0};
+        roots.push_back((int)ast.nodes.size());
+        ast.nodes.push_back(node);
+    }
+
+public:
+    vector<string> errors;      // 错误信息，按报告顺序
+
+    AstBuilder(const Grammar& grammar, CompactAst& a) : ast(a) {
+        roles.assign(grammar.symbolNames.size(), ROLE_NONE);
+        setRole(grammar, "program", ROLE_PASS);
+        setRole(grammar, "stmt", ROLE_PASS);
+        setRole(grammar, "arithexpr", ROLE_PASS);
+        setRole(grammar, "multexpr", ROLE_PASS);
+        setRole(grammar, "simpleexpr", ROLE_PASS);
+        setRole(grammar, "compoundstmt", ROLE_BLOCK);
+        setRole(grammar, "ifstmt", ROLE_IF);
+        setRole(grammar, "whilestmt", ROLE_WHILE);
+        setRole(grammar, "assgstmt", ROLE_ASSIGN);
+        setRole(grammar, "boolexpr", ROLE_COMPARE);
+        setRole(grammar, "boolop", ROLE_OPERATOR);
+        setRole(grammar, "arithexprprime", ROLE_TAIL);
+        setRole(grammar, "multexprprime", ROLE_TAIL);
+        ast.clear();
+    }
+
+    void onEnter(int nonTerminal) {
+        if (!frames.empty()) frames.back().matched = true;
+        Frame frame = {roles[nonTerminal], false, TK_END, roots.size()};
+        frames.push_back(frame);
+    }
+
+    void onToken(int symbol, const Token* token) {
+        if (symbol >= TOKEN_KIND_COUNT) return;     // 空串E
+        Frame& top = frames.back();
+        top.matched = true;
+        switch (top.role) {
+        case ROLE_PASS:
+        case ROLE_ASSIGN:
+            // simpleexpr中的ID/NUM，assgstmt的左部；错误恢复插入的ID没有对应的token
+            if (symbol == TK_ID || symbol == TK_NUM) {
+                emitLeaf(token == nullptr ? AST_ERROR : symbol == TK_ID ? AST_ID : AST_NUM, token);
+            }
+            break;
+        case ROLE_TAIL:
+            top.op = symbol;
+            break;
+        case ROLE_OPERATOR:
+            frames[frames.size() - 2].op = symbol;
+            break;
+        }
+    }
+
+    void onExit(int) {
+        Frame frame = frames.back();
+        frames.pop_back();
+        size_t produced = roots.size() - frame.mark;
+
+        switch (frame.role) {
+        case ROLE_NONE:
+        case ROLE_TAIL:
+        case ROLE_OPERATOR:
+            return;
+        case ROLE_PASS:
+            if (produced == 0) emitLeaf(AST_ERROR, nullptr);
+            break;
+        case ROLE_BLOCK:
+            // 空的复合语句也是一个节点
+            if (frame.matched) {
+                emitNode(AST_BLOCK, produced, 0);
+            } else {
+                emitLeaf(AST_ERROR, nullptr);
+            }
+            break;
+        case ROLE_IF:
+        case ROLE_WHILE:
+        case ROLE_ASSIGN:
+        case ROLE_COMPARE:
+            // 没有选中产生式时什么都没有留下；选中时各子非终结符都恰好留下一棵子树
+            if (produced == 0) {
+                emitLeaf(AST_ERROR, nullptr);
+            } else {
+                emitNode(nodeKind(frame.role), produced, frame.role == ROLE_COMPARE ? frame.op : 0);
+            }
+            break;
+        }
+
+        // 运算符后的右操作数结束：与左操作数合并为二元表达式
+        if (frame.role == ROLE_PASS && !frames.empty() && frames.back().role == ROLE_TAIL) {
+            emitNode(AST_BINARY, 2, frames.back().op);
+        }
+    }
+
+    void onError(const string& message) {
+        errors.push_back(message);
+    }
+};
+
+#endif
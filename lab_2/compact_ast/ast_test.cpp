@@ -0,0 +1,111 @@
+// 紧凑抽象语法树测试程序
+// 测试AstBuilder构建的抽象语法树：运算符的优先级和结合性、各种语句的形状，
+// 含错误的程序仍得到形状完整的树，错误信息与parse(prog)相同
+
+#include "CompactAst.h"
+#include "../../common/test_util.h"
+
+/* 分析程序，返回抽象语法树的S表达式 */
+string lower(LLParser& parser, const string& prog, CompactAst& ast, vector<string>& errors) {
+    AstBuilder builder(parser.getGrammar(), ast);
+    parser.parse(prog, builder);
+    errors = builder.errors;
+    return ast.toString(prog);
+}
+
+string lower(LLParser& parser, const string& prog) {
+    CompactAst ast;
+    vector<string> errors;
+    return lower(parser, prog, ast, errors);
+}
+
+/* 检查后序数组的形状：根覆盖所有节点，每个内部节点的子树大小与子节点数相符 */
+bool wellFormed(const CompactAst& ast) {
+    if (ast.nodes.empty() || ast.nodes.back().size != ast.nodes.size()) return false;
+    for (int id = 0; id < (int)ast.nodes.size(); id++) {
+        const AstNode& node = ast.nodes[id];
+        bool leaf = node.kind == AST_ID || node.kind == AST_NUM || node.kind == AST_ERROR;
+        if (leaf) {
+            if (node.size != 1) return false;
+            continue;
+        }
+        uint32_t count = 0, size = 1;
+        for (int c = ast.lastChild(id); c >= 0; c = ast.prevSibling(c, id)) {
+            count++;
+            size += ast.nodes[c].size;
+        }
+        if (count != node.count || size != node.size) return false;
+        if ((node.kind == AST_BINARY || node.kind == AST_ASSIGN || node.kind == AST_WHILE) && count != 2) return false;
+        if (node.kind == AST_IF && count != 3) return false;
+    }
+    return true;
+}
+
+void testExpressions() {
+    cout << "\n=== 表达式 ===" << endl;
+    LLParser parser;
+    check(lower(parser, "{ x = a + b * c - d ; }") == "(block (assign x (- (+ a (* b c)) d)))",
+          "乘除优先于加减，同级左结合");
+    check(lower(parser, "{ x = a / b / c ; }") == "(block (assign x (/ (/ a b) c)))", "除法左结合");
+    check(lower(parser, "{ x = ( ( a + 1 ) ) * 2 ; }") == "(block (assign x (* (+ a 1) 2)))",
+          "括号只影响结构，不产生节点");
+    check(lower(parser, "{ while ( a + 1 <= b ) x = 1 ; }") ==
+          "(block (while (<= (+ a 1) b) (assign x 1)))", "比较表达式");
+}
+
+void testStatements() {
+    cout << "\n=== 语句 ===" << endl;
+    LLParser parser;
+    check(lower(parser, "{ }") == "(block)", "空的复合语句");
+    check(lower(parser, "{ if ( a < b ) then x = 1 ; else { y = 2 ; { } } }") ==
+          "(block (if (< a b) (assign x 1) (block (assign y 2) (block))))", "if语句和嵌套的复合语句");
+
+    CompactAst ast;
+    vector<string> errors;
+    string prog = "{ x = 1 ; y = ( x + 2 ) * 3 ; while ( x < 10 ) { x = x + 1 ; } }";
+    lower(parser, prog, ast, errors);
+    const ParseTree& tree = parser.parse(prog);
+    check(wellFormed(ast) && ast.nodes.size() == 21 && tree.size() > 4 * ast.nodes.size(),
+          "节点数不到具体语法树的四分之一");
+}
+
+void testErrors() {
+    cout << "\n=== 错误恢复 ===" << endl;
+    LLParser parser;
+    check(lower(parser, "{ x = ; }") == "(block (assign x <error>))", "缺少表达式");
+    check(lower(parser, "") == "<error>", "空输入");
+
+    // 依次删去一个正确程序中的每个token，各种错误恢复后树的形状都完整
+    string prog = "{ if ( a < b ) then x = ( a + 1 ) * b ; else while ( a == b ) { y = b - 2 ; } }";
+    vector<string> words;
+    istringstream in(prog);
+    string word;
+    while (in >> word) {
+        words.push_back(word);
+    }
+    bool shapes = true, sameErrors = true;
+    for (size_t skip = 0; skip < words.size(); skip++) {
+        string broken;
+        for (size_t i = 0; i < words.size(); i++) {
+            if (i != skip) broken += words[i] + "\n";
+        }
+        CompactAst ast;
+        vector<string> errors;
+        lower(parser, broken, ast, errors);
+        shapes = shapes && wellFormed(ast);
+
+        SyntaxChecker checker;
+        parser.parse(broken, checker);
+        sameErrors = sameErrors && errors == checker.errors;
+    }
+    check(shapes, "缺少任一token时树的形状完整");
+    check(sameErrors, "错误信息与parse(prog)相同");
+}
+
+int main() {
+    testExpressions();
+    testStatements();
+    testErrors();
+
+    return testSummary();
+}
@@ -0,0 +1,189 @@
+// 事件模式测试程序
+// 测试LLParser::parse(prog, handler)报告的事件：由TreeBuilder还原的语法树和错误信息
+// 与parse(prog)相同，SyntaxChecker只检查语法，事件的嵌套关系完整
+
+#include "../LLparser.h"
+#include "../../common/test_util.h"
+
+const char* programs[] = {
+    "{\nID = NUM ;\n}",
+    "{\nwhile ( ID == NUM )\n{\nID = ID + NUM * ( ID - NUM ) ;\n}\n}",
+    "{\nif ( ID < NUM ) then ID = NUM ; else ID = ID ;\n}",
+    "{\nID = NUM\n}",
+    "{\nif ( ID > NUM ) ID = NUM ; else ID = NUM ;\n}",
+    "{\nID = NUM ;\n} } ;\nelse",
+    "",
+    "while ( ID"
+};
+const size_t programCount = sizeof(programs) / sizeof(programs[0]);
+
+/* 检查事件的嵌套关系，并把叶子还原为源程序的token序列 */
+class EventRecorder {
+private:
+    const string& prog;
+    vector<int> open;
+
+public:
+    bool balanced;              // onExit与最近的onEnter相符，叶子都在某个非终结符之下
+    bool leavesValid;           // 匹配的token种类与符号一致，插入的叶子不带token
+    int errors;
+    string tokens;              // 匹配到的token，以空格分隔
+
+    EventRecorder(const string& p) : prog(p), balanced(true), leavesValid(true), errors(0) {}
+
+    void onEnter(int nonTerminal) {
+        open.push_back(nonTerminal);
+    }
+
+    void onToken(int symbol, const Token* token) {
+        if (open.empty()) balanced = false;
+        if (token != nullptr) {
+            if (token->kind != symbol) leavesValid = false;
+            tokens += (tokens.empty() ? "" : " ") + prog.substr(token->offset, token->length);
+        }
+    }
+
+    void onExit(int nonTerminal) {
+        if (open.empty() || open.back() != nonTerminal) balanced = false;
+        if (!open.empty()) open.pop_back();
+    }
+
+    void onError(const string&) {
+        errors++;
+    }
+
+    bool finished() const {
+        return open.empty();
+    }
+};
+
+void testTreeBuilder() {
+    cout << "\n=== TreeBuilder ===" << endl;
+    LLParser parser;
+    bool same = true;
+    for (size_t i = 0; i < programCount; i++) {
+        string expected = parseAndPrint(parser, programs[i]);
+
+        ParseTree tree(parser.getGrammar());
+        TreeBuilder builder(tree);
+        parser.parse(programs[i], builder);
+        stringstream actual;
+        for (const auto& err : builder.errors) {
+            actual << err << endl;
+        }
+        tree.print(actual);
+        same = same && actual.str() == expected;
+    }
+    check(same, "由事件构建的语法树和错误信息与parse(prog)相同（含错误恢复）");
+}
+
+void testSyntaxChecker() {
+    cout << "\n=== SyntaxChecker ===" << endl;
+    LLParser parser;
+    SyntaxChecker ok, bad;
+    parser.parse(programs[1], ok);
+    check(ok.errors.empty(), "正确的程序没有错误");
+    parser.parse(programs[3], bad);
+    check(bad.errors.size() == 1 && bad.errors[0] == "语法错误,第2行,缺少\";\"", "缺少分号");
+
+    bool same = true;
+    for (size_t i = 0; i < programCount; i++) {
+        SyntaxChecker checker;
+        parser.parse(programs[i], checker);
+        string errors;
+        for (const auto& err : checker.errors) {
+            errors += err + "\n";
+        }
+        string output = parseAndPrint(parser, programs[i]);
+        // parse(prog)先输出错误信息，紧接着是从program开始的语法树
+        same = same && output.compare(0, errors.size() + 7, errors + "program") == 0;
+    }
+    check(same, "错误信息与parse(prog)输出的相同");
+}
+
+void testEvents() {
+    cout << "\n=== 事件顺序 ===" << endl;
+    LLParser parser;
+    bool balanced = true, leavesValid = true;
+    for (size_t i = 0; i < programCount; i++) {
+        string prog = programs[i];
+        EventRecorder recorder(prog);
+        parser.parse(prog, recorder);
+        balanced = balanced && recorder.balanced && recorder.finished();
+        leavesValid = leavesValid && recorder.leavesValid;
+    }
+    check(balanced, "onEnter与onExit一一对应");
+    check(leavesValid, "匹配的叶子带有对应的token");
+
+    string prog = "{ x = ( 1 + y ) * 2 ; while ( a < b ) { } }";
+    EventRecorder recorder(prog);
+    parser.parse(prog, recorder);
+    check(recorder.tokens == prog && recorder.errors == 0, "无错误时叶子依次是全部token");
+}
+
+void testLexer() {
+    cout << "\n=== 按需取token ===" << endl;
+    bool same = true, endRepeats = true;
+    Lexer lexer;
+    for (size_t i = 0; i < programCount; i++) {
+        string prog = programs[i];
+        vector<Token> expected = Lexer(prog).tokenize();
+        lexer.reset(prog);
+        Token token;
+        for (const Token& t : expected) {
+            lexer.next(token);
+            same = same && token.kind == t.kind && token.offset == t.offset &&
+                   token.length == t.length && token.line == t.line;
+        }
+        lexer.next(token);
+        endRepeats = endRepeats && token.kind == TK_END && token.line == expected.back().line;
+    }
+    check(same, "逐个取得的token与tokenize()的结果相同");
+    check(endRepeats, "输入结束后一直得到$");
+
+    // 缺少的终结符按前一个token的行号报告，而不是当前token（下一行的}）的行号
+    LLParser parser;
+    SyntaxChecker checker;
+    parser.parse("{\nID = NUM\n\n}", checker);
+    check(checker.errors.size() == 1 && checker.errors[0] == "语法错误,第2行,缺少\";\"", "错误行号取前一个token的行号");
+}
+
+void testRecovery() {
+    cout << "\n=== 错误恢复 ===" << endl;
+    LLAnalysis analysis;
+    const Grammar& grammar = analysis.getGrammar();
+    const ParseTable& table = analysis.getParseTable();
+    bool same = true;
+    for (int n = TOKEN_KIND_COUNT; n < grammar.epsilonId; n++) {
+        bool nullable = false;
+        for (int p : grammar.productionsOf[n - TOKEN_KIND_COUNT]) {
+            nullable = nullable || grammar.productionList[p].length == 0;
+        }
+        for (int t = 0; t < TOKEN_KIND_COUNT; t++) {
+            bool epsilon = grammar.analysis.follow(n).contains(t) || nullable ||
+                           (grammar.symbolName(n) == "stmts" && t == TK_RBRACE);
+            same = same && table.recoversWithEpsilon(n, t) == epsilon &&
+                   table.isSync(n, t) == (epsilon || table.lookup(n, t) >= 0);
+        }
+    }
+    check(same, "恢复集合和同步集合与FOLLOW集合、空产生式的定义一致");
+
+    // 开头的大量无法展开program的token被逐个跳过，之后的程序正常分析
+    LLParser parser(analysis);
+    string clean = "{\nID = NUM ;\n}";
+    size_t expectedSize = parser.parse(clean).size();
+    string skipped;
+    for (int i = 0; i < 100000; i++) skipped += "else ) ";
+    const ParseTree& tree = parser.parse(skipped + clean);
+    check(tree.size() == expectedSize, "跳过10万个token后得到同样的语法树");
+}
+
+int main() {
+    testTreeBuilder();
+    testSyntaxChecker();
+    testEvents();
+    testLexer();
+    testRecovery();
+
+    return testSummary();
+}
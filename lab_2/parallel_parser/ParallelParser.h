@@ -0,0 +1,74 @@
+// ============================================================
+// 多线程语法分析
+// 功能：多个工作线程共用一个只读的LLAnalysis（文法和分析表），
+//       每个线程有自己的LLParser、语法树和输出缓冲，互不加锁
+// 分配：各线程用一个原子计数器依次领取下一个程序，程序大小不均时也能保持忙碌
+// 编译时需要-pthread
+// ============================================================
+#ifndef PARALLEL_PARSER_H
+#define PARALLEL_PARSER_H
+
+#include "../batch_parser/BatchInput.h"   // 其中包含LLparser.h（该文件没有包含保护，不能重复包含）
+#include <atomic>
+#include <thread>
+
+class ParallelParser {
+private:
+    const LLAnalysis& analysis;
+    const vector<string>* programs;
+    vector<string>* outputs;
+    bool quiet;
+    atomic<size_t> next;
+
+    // 工作线程：领取程序直到全部分析完，输出写入outputs中对应的位置
+    void work() {
+        LLParser parser(analysis);
+        ParseTree tree(analysis.getGrammar());
+        TreeBuilder builder(tree);
+        SyntaxChecker checker;
+        ostringstream out;
+
+        for (size_t i = next++; i < programs->size(); i = next++) {
+            const string& prog = (*programs)[i];
+            out.str("");
+            if (quiet) {
+                checker.errors.clear();
+                parser.parse(prog, checker);
+                out << checker.errors.size() << "个错误" << endl;
+            } else {
+                // 与parse(prog)相同：先输出错误信息，再输出语法树
+                builder.reset();
+                parser.parse(prog, builder);
+                for (const auto& err : builder.errors) {
+                    out << err << endl;
+                }
+                tree.print(out);
+            }
+            (*outputs)[i] = out.str();
+        }
+    }
+
+public:
+    ParallelParser(const LLAnalysis& a) : analysis(a), programs(nullptr), outputs(nullptr), quiet(false), next(0) {}
+
+    // 用threads个线程分析progs，outputs[i]为第i个程序的输出
+    // quiet为true时只输出错误数，否则输出与main.cpp相同的错误信息和语法树
+    void parseAll(const vector<string>& progs, vector<string>& out, bool onlyErrors, int threads) {
+        programs = &progs;
+        outputs = &out;
+        quiet = onlyErrors;
+        next = 0;
+        out.assign(progs.size(), string());
+
+        vector<thread> workers;
+        for (int t = 1; t < threads; t++) {
+            workers.push_back(thread(&ParallelParser::work, this));
+        }
+        work();     // 当前线程也参与分析
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+};
+
+#endif
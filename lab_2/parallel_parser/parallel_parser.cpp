@@ -0,0 +1,59 @@
+// 多线程批量语法分析程序
+// 读入一批程序，由多个线程共用一份文法和分析表并行分析，按输入顺序输出结果
+// 用法：./parallel_parser [-q] [-j 线程数] 目录|-
+//   目录、"-"（标准输入中以"%%"行分隔的程序）和-q的含义与batch_parser相同
+//   线程数默认为CPU核数。最后在cerr输出程序数、线程数和分析耗时
+
+#include "ParallelParser.h"
+#include <chrono>
+#include <cstdlib>
+
+int main(int argc, char* argv[]) {
+    bool quiet = false;
+    int threads = max(1, (int)thread::hardware_concurrency());   // 无法得知核数时返回0
+    string source;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "-q") {
+            quiet = true;
+        } else if (arg == "-j" && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else {
+            source = arg;
+        }
+    }
+    if (source.empty() || threads < 1) {
+        cerr << "用法: " << argv[0] << " [-q] [-j 线程数] 目录|-" << endl;
+        return 2;
+    }
+
+    BatchInput input;
+    if (source == "-") {
+        input.openStream(cin);
+    } else if (!input.openDirectory(source)) {
+        cerr << "无法打开目录: " << source << endl;
+        return 1;
+    }
+    vector<string> names, programs, outputs;
+    while (input.next()) {
+        names.push_back(input.name);
+        programs.push_back(input.prog);
+    }
+
+    LLAnalysis analysis;
+    ParallelParser parser(analysis);
+    auto start = chrono::steady_clock::now();
+    parser.parseAll(programs, outputs, quiet, threads);
+    auto end = chrono::steady_clock::now();
+
+    for (size_t i = 0; i < outputs.size(); i++) {
+        if (quiet) {
+            cout << names[i] << ": " << outputs[i];
+        } else {
+            cout << "=== " << names[i] << " ===" << endl << outputs[i];
+        }
+    }
+    cerr << programs.size() << "个程序，" << threads << "个线程，用时"
+         << chrono::duration<double>(end - start).count() << "秒" << endl;
+    return 0;
+}
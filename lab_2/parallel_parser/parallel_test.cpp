@@ -0,0 +1,82 @@
+// 多线程语法分析测试程序
+// 测试不同线程数下ParallelParser的输出与单线程LLParser逐个分析的输出相同，且按输入顺序排列
+
+#include "ParallelParser.h"
+#include "../../common/test_util.h"
+
+/* 构造一批大小不一、有对有错的程序 */
+vector<string> makePrograms() {
+    const char* pieces[] = {
+        "ID = NUM ;\n",
+        "while ( ID == NUM )\n{\nID = ID + NUM * ( ID - NUM ) ;\n}\n",
+        "if ( ID > NUM ) ID = NUM ; else ID = NUM ;\n",
+        "ID = NUM\n",
+        "ID = ( ID + ;\n"
+    };
+    vector<string> progs;
+    for (int i = 0; i < 200; i++) {
+        string prog = "{\n";
+        for (int j = 0; j <= i % 17; j++) {
+            prog += pieces[(i * 7 + j) % 5];
+        }
+        prog += "}";
+        progs.push_back(prog);
+    }
+    progs.push_back("");
+    return progs;
+}
+
+void testThreads(const vector<string>& progs) {
+    cout << "\n=== 多线程输出 ===" << endl;
+    LLAnalysis analysis;
+    LLParser single(analysis);
+    vector<string> expected;
+    int withErrors = 0;
+    for (const auto& prog : progs) {
+        expected.push_back(parseAndPrint(single, prog));
+        if (expected.back().compare(0, strlen("语法错误"), "语法错误") == 0) withErrors++;
+    }
+    check(withErrors > 0 && withErrors < (int)progs.size(), "测试程序中既有正确的也有错误的");
+
+    ParallelParser parser(analysis);
+    vector<string> outputs;
+    int threadCounts[] = {1, 2, 4, 8};
+    for (int threads : threadCounts) {
+        parser.parseAll(progs, outputs, false, threads);
+        check(outputs == expected, to_string(threads) + "个线程的输出与单线程逐个分析相同");
+    }
+}
+
+void testQuiet(const vector<string>& progs) {
+    cout << "\n=== 只统计错误数 ===" << endl;
+    LLAnalysis analysis;
+    LLParser single(analysis);
+    SyntaxChecker checker;
+    vector<string> expected;
+    for (const auto& prog : progs) {
+        checker.errors.clear();
+        single.parse(prog, checker);
+        expected.push_back(to_string(checker.errors.size()) + "个错误\n");
+    }
+
+    ParallelParser parser(analysis);
+    vector<string> outputs;
+    parser.parseAll(progs, outputs, true, 4);
+    check(outputs == expected, "4个线程的错误数与单线程相同");
+
+    // 同一个ParallelParser再次分析，上一次的结果不残留
+    vector<string> first(progs.begin(), progs.begin() + 3);
+    parser.parseAll(first, outputs, true, 3);
+    check(outputs.size() == 3 && outputs[2] == expected[2], "再次分析时输出只含本批程序");
+
+    parser.parseAll(vector<string>(), outputs, true, 4);
+    check(outputs.empty(), "空的一批程序");
+}
+
+int main() {
+    vector<string> progs = makePrograms();
+    testThreads(progs);
+    testQuiet(progs);
+
+    return testSummary();
+}
@@ -0,0 +1,533 @@
+// 由rd_generator根据文法生成的递归下降分析器，请勿手工修改
+// 重新生成：make GeneratedParser.h
+#ifndef GENERATED_PARSER_H
+#define GENERATED_PARSER_H
+
+#include "../LLparser.h"
+
+class GeneratedParser {
+public:
+    // 生成时所用文法的散列值，与运行时文法不同说明需要重新生成
+    static const uint64_t GRAMMAR_HASH = 0xf2df919bcb8cfb62ULL;
+
+    // 非终结符函数的最大嵌套层数（每层{ }或括号约三层），超过时改用LLParser的显式分析栈，
+    // 不会因输入嵌套过深而栈溢出
+    enum { MAX_DEPTH = 30000 };
+
+private:
+    GrammarFile file;           // 嵌套过深时构造LLParser用
+    Grammar grammar;            // 只用于输出语法树时取得符号名
+    Lexer lexer;                // 按需产生token
+    Token lookahead;            // 当前token
+    int prevTokenLine;          // 前一个token的行号，还没有时为-1
+    vector<string> errors;
+    int lastErrorLine;
+    ParseTree tree;
+    int depth;                  // 当前非终结符函数的嵌套层数
+    bool tooDeep;               // 本次分析是否因嵌套过深而放弃
+    unique_ptr<LLParser> fallback;  // 嵌套过深时使用的表驱动分析器，第一次用到时构造
+
+    // 进入非终结符函数时增加嵌套层数，返回时恢复
+    struct DepthGuard {
+        int& depth;
+        explicit DepthGuard(int& d) : depth(d) { depth++; }
+        ~DepthGuard() { depth--; }
+    };
+
+    // 放弃本次分析：把当前token置为输入结束，各层函数随即返回，由parse()改用LLParser
+    void abandon() {
+        tooDeep = true;
+        lookahead.kind = TK_END;
+    }
+
+    void advance() {
+        if (lookahead.kind != TK_END) {
+            prevTokenLine = lookahead.line;
+            lexer.next(lookahead);
+        }
+    }
+
+    // 匹配终结符，缺少时报错并插入该终结符（与LLParser::handleMissingTerminal相同）
+    void match(int expected, int parent) {
+        if (lookahead.kind == expected) {
+            tree.appendNode(parent, expected);
+            advance();
+            return;
+        }
+        int line = prevTokenLine >= 0 ? prevTokenLine : lookahead.line;
+        if (line != lastErrorLine || errors.empty()) {
+            errors.push_back("语法错误,第" + to_string(line) + "行,缺少\"" + tokenKindName(expected) + "\"");
+            lastErrorLine = line;
+        }
+        tree.appendNode(parent, expected);
+    }
+
+    // arithexpr -> multexpr arithexprprime
+    void parse_arithexpr(int node) {
+        DepthGuard guard(depth);
+        if (depth > MAX_DEPTH) return abandon();
+        for (;;) {
+            switch (lookahead.kind) {
+            case TK_LPAREN:
+            case TK_ID:
+            case TK_NUM:
+                parse_multexpr(tree.appendNode(node, 29 /* multexpr */));
+                parse_arithexprprime(tree.appendNode(node, 23 /* arithexprprime */));
+                return;
+            // 错误恢复：按空产生式处理
+            case TK_RPAREN:
+            case TK_SEMI:
+            case TK_LT:
+            case TK_GT:
+            case TK_LE:
+            case TK_GE:
+            case TK_EQ:
+                tree.appendNode(node, 36 /* E */);
+                return;
+            default:
+                // 错误恢复：跳过当前token后重试
+                advance();
+                if (lookahead.kind == TK_END) return;
+            }
+        }
+    }
+
+    // arithexprprime -> + multexpr arithexprprime | - multexpr arithexprprime | E
+    void parse_arithexprprime(int node) {
+        DepthGuard guard(depth);
+        if (depth > MAX_DEPTH) return abandon();
+        for (;;) {
+            switch (lookahead.kind) {
+            case TK_PLUS:
+                tree.appendNode(node, TK_PLUS);
+                advance();
+                parse_multexpr(tree.appendNode(node, 29 /* multexpr */));
+                node = tree.appendNode(node, 23 /* arithexprprime */);
+                continue;
+            case TK_MINUS:
+                tree.appendNode(node, TK_MINUS);
+                advance();
+                parse_multexpr(tree.appendNode(node, 29 /* multexpr */));
+                node = tree.appendNode(node, 23 /* arithexprprime */);
+                continue;
+            case TK_RPAREN:
+            case TK_SEMI:
+            case TK_LT:
+            case TK_GT:
+            case TK_LE:
+            case TK_GE:
+            case TK_EQ:
+                tree.appendNode(node, 36 /* E */);
+                return;
+            // 错误恢复：按空产生式处理
+            default:
+                tree.appendNode(node, 36 /* E */);
+                return;
+            }
+        }
+    }
+
+    // assgstmt -> ID = arithexpr ;
+    void parse_assgstmt(int node) {
+        DepthGuard guard(depth);
+        if (depth > MAX_DEPTH) return abandon();
+        for (;;) {
+            switch (lookahead.kind) {
+            case TK_ID:
+                tree.appendNode(node, TK_ID);
+                advance();
+                match(TK_ASSIGN, node);
+                parse_arithexpr(tree.appendNode(node, 22 /* arithexpr */));
+                match(TK_SEMI, node);
+                return;
+            // 错误恢复：按空产生式处理
+            case TK_LBRACE:
+            case TK_RBRACE:
+            case TK_IF:
+            case TK_ELSE:
+            case TK_WHILE:
+                tree.appendNode(node, 36 /* E */);
+                return;
+            default:
+                // 错误恢复：跳过当前token后重试
+                advance();
+                if (lookahead.kind == TK_END) return;
+            }
+        }
+    }
+
+    // boolexpr -> arithexpr boolop arithexpr
+    void parse_boolexpr(int node) {
+        DepthGuard guard(depth);
+        if (depth > MAX_DEPTH) return abandon();
+        for (;;) {
+            switch (lookahead.kind) {
+            case TK_LPAREN:
+            case TK_ID:
+            case TK_NUM:
+                parse_arithexpr(tree.appendNode(node, 22 /* arithexpr */));
+                parse_boolop(tree.appendNode(node, 26 /* boolop */));
+                parse_arithexpr(tree.appendNode(node, 22 /* arithexpr */));
+                return;
+            // 错误恢复：按空产生式处理
+            case TK_RPAREN:
+                tree.appendNode(node, 36 /* E */);
+                return;
+            default:
+                // 错误恢复：跳过当前token后重试
+                advance();
+                if (lookahead.kind == TK_END) return;
+            }
+        }
+    }
+
+    // boolop -> < | > | <= | >= | ==
+    void parse_boolop(int node) {
+        DepthGuard guard(depth);
+        if (depth > MAX_DEPTH) return abandon();
+        for (;;) {
+            switch (lookahead.kind) {
+            case TK_LT:
+                tree.appendNode(node, TK_LT);
+                advance();
+                return;
+            case TK_GT:
+                tree.appendNode(node, TK_GT);
+                advance();
+                return;
+            case TK_LE:
+                tree.appendNode(node, TK_LE);
+                advance();
+                return;
+            case TK_GE:
+                tree.appendNode(node, TK_GE);
+                advance();
+                return;
+            case TK_EQ:
+                tree.appendNode(node, TK_EQ);
+                advance();
+                return;
+            // 错误恢复：按空产生式处理
+            case TK_LPAREN:
+            case TK_ID:
+            case TK_NUM:
+                tree.appendNode(node, 36 /* E */);
+                return;
+            default:
+                // 错误恢复：跳过当前token后重试
+                advance();
+                if (lookahead.kind == TK_END) return;
+            }
+        }
+    }
+
+    // compoundstmt -> { stmts }
+    void parse_compoundstmt(int node) {
+        DepthGuard guard(depth);
+        if (depth > MAX_DEPTH) return abandon();
+        for (;;) {
+            switch (lookahead.kind) {
+            case TK_LBRACE:
+                tree.appendNode(node, TK_LBRACE);
+                advance();
+                parse_stmts(tree.appendNode(node, 34 /* stmts */));
+                match(TK_RBRACE, node);
+                return;
+            // 错误恢复：按空产生式处理
+            case TK_RBRACE:
+            case TK_IF:
+            case TK_ELSE:
+            case TK_WHILE:
+            case TK_ID:
+            case TK_END:
+                tree.appendNode(node, 36 /* E */);
+                return;
+            default:
+                // 错误恢复：跳过当前token后重试
+                advance();
+                if (lookahead.kind == TK_END) return;
+            }
+        }
+    }
+
+    // ifstmt -> if ( boolexpr ) then stmt else stmt
+    void parse_ifstmt(int node) {
+        DepthGuard guard(depth);
+        if (depth > MAX_DEPTH) return abandon();
+        for (;;) {
+            switch (lookahead.kind) {
+            case TK_IF:
+                tree.appendNode(node, TK_IF);
+                advance();
+                match(TK_LPAREN, node);
+                parse_boolexpr(tree.appendNode(node, 25 /* boolexpr */));
+                match(TK_RPAREN, node);
+                match(TK_THEN, node);
+                parse_stmt(tree.appendNode(node, 33 /* stmt */));
+                match(TK_ELSE, node);
+                parse_stmt(tree.appendNode(node, 33 /* stmt */));
+                return;
+            // 错误恢复：按空产生式处理
+            case TK_LBRACE:
+            case TK_RBRACE:
+            case TK_ELSE:
+            case TK_WHILE:
+            case TK_ID:
+                tree.appendNode(node, 36 /* E */);
+                return;
+            default:
+                // 错误恢复：跳过当前token后重试
+                advance();
+                if (lookahead.kind == TK_END) return;
+            }
+        }
+    }
+
+    // multexpr -> simpleexpr multexprprime
+    void parse_multexpr(int node) {
+        DepthGuard guard(depth);
+        if (depth > MAX_DEPTH) return abandon();
+        for (;;) {
+            switch (lookahead.kind) {
+            case TK_LPAREN:
+            case TK_ID:
+            case TK_NUM:
+                parse_simpleexpr(tree.appendNode(node, 32 /* simpleexpr */));
+                parse_multexprprime(tree.appendNode(node, 30 /* multexprprime */));
+                return;
+            // 错误恢复：按空产生式处理
+            case TK_RPAREN:
+            case TK_SEMI:
+            case TK_LT:
+            case TK_GT:
+            case TK_LE:
+            case TK_GE:
+            case TK_EQ:
+            case TK_PLUS:
+            case TK_MINUS:
+                tree.appendNode(node, 36 /* E */);
+                return;
+            default:
+                // 错误恢复：跳过当前token后重试
+                advance();
+                if (lookahead.kind == TK_END) return;
+            }
+        }
+    }
+
+    // multexprprime -> * simpleexpr multexprprime | / simpleexpr multexprprime | E
+    void parse_multexprprime(int node) {
+        DepthGuard guard(depth);
+        if (depth > MAX_DEPTH) return abandon();
+        for (;;) {
+            switch (lookahead.kind) {
+            case TK_MUL:
+                tree.appendNode(node, TK_MUL);
+                advance();
+                parse_simpleexpr(tree.appendNode(node, 32 /* simpleexpr */));
+                node = tree.appendNode(node, 30 /* multexprprime */);
+                continue;
+            case TK_DIV:
+                tree.appendNode(node, TK_DIV);
+                advance();
+                parse_simpleexpr(tree.appendNode(node, 32 /* simpleexpr */));
+                node = tree.appendNode(node, 30 /* multexprprime */);
+                continue;
+            case TK_RPAREN:
+            case TK_SEMI:
+            case TK_LT:
+            case TK_GT:
+            case TK_LE:
+            case TK_GE:
+            case TK_EQ:
+            case TK_PLUS:
+            case TK_MINUS:
+                tree.appendNode(node, 36 /* E */);
+                return;
+            // 错误恢复：按空产生式处理
+            default:
+                tree.appendNode(node, 36 /* E */);
+                return;
+            }
+        }
+    }
+
+    // program -> compoundstmt
+    void parse_program(int node) {
+        DepthGuard guard(depth);
+        if (depth > MAX_DEPTH) return abandon();
+        for (;;) {
+            switch (lookahead.kind) {
+            case TK_LBRACE:
+                parse_compoundstmt(tree.appendNode(node, 27 /* compoundstmt */));
+                return;
+            // 错误恢复：按空产生式处理
+            case TK_END:
+                tree.appendNode(node, 36 /* E */);
+                return;
+            default:
+                // 错误恢复：跳过当前token后重试
+                advance();
+                if (lookahead.kind == TK_END) return;
+            }
+        }
+    }
+
+    // simpleexpr -> ID | NUM | ( arithexpr )
+    void parse_simpleexpr(int node) {
+        DepthGuard guard(depth);
+        if (depth > MAX_DEPTH) return abandon();
+        for (;;) {
+            switch (lookahead.kind) {
+            case TK_ID:
+                tree.appendNode(node, TK_ID);
+                advance();
+                return;
+            case TK_NUM:
+                tree.appendNode(node, TK_NUM);
+                advance();
+                return;
+            case TK_LPAREN:
+                tree.appendNode(node, TK_LPAREN);
+                advance();
+                parse_arithexpr(tree.appendNode(node, 22 /* arithexpr */));
+                match(TK_RPAREN, node);
+                return;
+            // 错误恢复：按空产生式处理
+            case TK_RPAREN:
+            case TK_SEMI:
+            case TK_LT:
+            case TK_GT:
+            case TK_LE:
+            case TK_GE:
+            case TK_EQ:
+            case TK_PLUS:
+            case TK_MINUS:
+            case TK_MUL:
+            case TK_DIV:
+                tree.appendNode(node, 36 /* E */);
+                return;
+            default:
+                // 错误恢复：跳过当前token后重试
+                advance();
+                if (lookahead.kind == TK_END) return;
+            }
+        }
+    }
+
+    // stmt -> ifstmt | whilestmt | assgstmt | compoundstmt
+    void parse_stmt(int node) {
+        DepthGuard guard(depth);
+        if (depth > MAX_DEPTH) return abandon();
+        for (;;) {
+            switch (lookahead.kind) {
+            case TK_IF:
+                parse_ifstmt(tree.appendNode(node, 28 /* ifstmt */));
+                return;
+            case TK_WHILE:
+                parse_whilestmt(tree.appendNode(node, 35 /* whilestmt */));
+                return;
+            case TK_ID:
+                parse_assgstmt(tree.appendNode(node, 24 /* assgstmt */));
+                return;
+            case TK_LBRACE:
+                parse_compoundstmt(tree.appendNode(node, 27 /* compoundstmt */));
+                return;
+            // 错误恢复：按空产生式处理
+            case TK_RBRACE:
+            case TK_ELSE:
+                tree.appendNode(node, 36 /* E */);
+                return;
+            default:
+                // 错误恢复：跳过当前token后重试
+                advance();
+                if (lookahead.kind == TK_END) return;
+            }
+        }
+    }
+
+    // stmts -> stmt stmts | E
+    void parse_stmts(int node) {
+        DepthGuard guard(depth);
+        if (depth > MAX_DEPTH) return abandon();
+        for (;;) {
+            switch (lookahead.kind) {
+            case TK_LBRACE:
+            case TK_IF:
+            case TK_WHILE:
+            case TK_ID:
+                parse_stmt(tree.appendNode(node, 33 /* stmt */));
+                node = tree.appendNode(node, 34 /* stmts */);
+                continue;
+            case TK_RBRACE:
+                tree.appendNode(node, 36 /* E */);
+                return;
+            // 错误恢复：按空产生式处理
+            default:
+                tree.appendNode(node, 36 /* E */);
+                return;
+            }
+        }
+    }
+
+    // whilestmt -> while ( boolexpr ) stmt
+    void parse_whilestmt(int node) {
+        DepthGuard guard(depth);
+        if (depth > MAX_DEPTH) return abandon();
+        for (;;) {
+            switch (lookahead.kind) {
+            case TK_WHILE:
+                tree.appendNode(node, TK_WHILE);
+                advance();
+                match(TK_LPAREN, node);
+                parse_boolexpr(tree.appendNode(node, 25 /* boolexpr */));
+                match(TK_RPAREN, node);
+                parse_stmt(tree.appendNode(node, 33 /* stmt */));
+                return;
+            // 错误恢复：按空产生式处理
+            case TK_LBRACE:
+            case TK_RBRACE:
+            case TK_IF:
+            case TK_ELSE:
+            case TK_ID:
+                tree.appendNode(node, 36 /* E */);
+                return;
+            default:
+                // 错误恢复：跳过当前token后重试
+                advance();
+                if (lookahead.kind == TK_END) return;
+            }
+        }
+    }
+
+public:
+    GeneratedParser(const GrammarFile& f = cSubsetGrammar())
+        : file(f), grammar(f), prevTokenLine(-1), lastErrorLine(-1), tree(grammar),
+          depth(0), tooDeep(false) {}
+
+    // 与LLParser::parse()相同：先输出错误信息，返回的语法树在下一次调用前有效
+    const ParseTree& parse(const string& prog) {
+        lexer.reset(prog);
+        lexer.next(lookahead);
+        prevTokenLine = -1;
+        errors.clear();
+        lastErrorLine = -1;
+        depth = 0;
+        tooDeep = false;
+        tree.clear();
+        tree.reserve(prog.size() * 3 / 2 + 1);
+        tree.root = tree.newNode(31 /* program */);
+        parse_program(tree.root);
+        if (tooDeep) {
+            // 已产生的错误信息和语法树作废，由LLParser重新分析并输出
+            if (!fallback) fallback.reset(new LLParser(file));
+            return fallback->parse(prog);
+        }
+        for (const auto& err : errors) {
+            cout << err << endl;
+        }
+        return tree;
+    }
+};
+
+#endif
@@ -0,0 +1,145 @@
+// 生成的递归下降分析器与表驱动LL(1)分析器的对比程序
+// 用法：
+//   ./rd_benchmark 程序文件...   对每个文件比较两个分析器的语法树和错误输出，并比较分析耗时
+//   ./rd_benchmark --generated [程序文件...]
+//                                先比较程序生成的大输入、深层嵌套输入和有错误的深层嵌套输入
+//   ./rd_benchmark --print       从标准输入读取程序，用生成的分析器输出错误和语法树（与main.cpp相同）
+
+#include "GeneratedParser.h"
+#include <chrono>
+
+// 读取整个文件，失败时返回false
+bool readFile(const string& path, string& content) {
+    ifstream in(path.c_str(), ios::binary);
+    if (!in) return false;
+    stringstream ss;
+    ss << in.rdbuf();
+    content = ss.str();
+    return true;
+}
+
+// 两棵语法树的节点数组是否完全相同（节点按创建顺序编号，结构相同则数组相同）
+bool sameTree(const ParseTree& a, const ParseTree& b) {
+    if (a.root != b.root || a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        const TreeNode& x = a.node((int)i);
+        const TreeNode& y = b.node((int)i);
+        if (x.symbol != y.symbol || x.firstChild != y.firstChild ||
+            x.lastChild != y.lastChild || x.nextSibling != y.nextSibling) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 分析一次，返回分析期间写到cout的错误信息
+template <class Parser>
+string parseCapturingErrors(Parser& parser, const string& prog, const ParseTree*& tree) {
+    ostringstream captured;
+    streambuf* saved = cout.rdbuf(captured.rdbuf());
+    tree = &parser.parse(prog);
+    cout.rdbuf(saved);
+    return captured.str();
+}
+
+// 重复分析rounds次，返回平均每次的毫秒数（错误信息丢弃）
+template <class Parser>
+double timeParser(Parser& parser, const string& prog, int rounds) {
+    ostringstream discard;
+    streambuf* saved = cout.rdbuf(discard.rdbuf());
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+        parser.parse(prog);
+    }
+    auto end = chrono::steady_clock::now();
+    cout.rdbuf(saved);
+    return chrono::duration<double, milli>(end - start).count() / rounds;
+}
+
+// 重复count次
+string repeat(const string& text, int count) {
+    string result;
+    result.reserve(text.size() * count);
+    for (int i = 0; i < count; i++) {
+        result += text;
+    }
+    return result;
+}
+
+// --generated使用的输入：名称和程序
+// 嵌套层数是MAX_DEPTH的5/3倍（调用层数约为MAX_DEPTH的5倍），生成的分析器在其中放弃并改用LLParser
+vector<pair<string, string>> generatedInputs() {
+    const int levels = GeneratedParser::MAX_DEPTH * 5 / 3;
+    vector<pair<string, string>> inputs;
+    inputs.push_back(make_pair("生成: 约1MB的程序", "{\n" + repeat(
+        "  count = ( alpha + 12 ) * beta / 3 ;\n"
+        "  if ( a == b ) then y = 2 ; else { z = 3 ; }\n"
+        "  while ( ID <= NUM ) { x = x - 1 ; }\n", 8000) + "}\n"));
+    inputs.push_back(make_pair("生成: 深层嵌套的{ }",
+        "{\n" + repeat("{ ", levels) + "x = 1 ;" + repeat(" }", levels) + "\n}\n"));
+    inputs.push_back(make_pair("生成: 深层嵌套的括号",
+        "{\nx = " + repeat("( ", levels) + "1" + repeat(" )", levels) + " ;\n}\n"));
+    // 最内层的语句缺少表达式和括号，外层只有一半的}：错误恢复要在深层进行，输入结束时还有大量未匹配的{
+    inputs.push_back(make_pair("生成: 有错误的深层嵌套",
+        "{\n" + repeat("{ ", levels) + "x = ( 1 + ; y = ) ;" + repeat(" }", levels / 2) + "\n"));
+    return inputs;
+}
+
+// 比较两个分析器对prog的语法树和错误输出，并比较分析耗时，返回结果是否一致
+bool compare(const string& name, const string& prog, LLParser& tableDriven, GeneratedParser& generated) {
+    const ParseTree* expectedTree;
+    const ParseTree* actualTree;
+    string expectedErrors = parseCapturingErrors(tableDriven, prog, expectedTree);
+    string actualErrors = parseCapturingErrors(generated, prog, actualTree);
+    bool same = expectedErrors == actualErrors && sameTree(*expectedTree, *actualTree);
+
+    // 小文件多分析几轮，使计时不小于约0.1秒
+    int rounds = max(1, (int)(200000 / (prog.size() + 1)));
+    double tableMs = timeParser(tableDriven, prog, rounds);
+    double generatedMs = timeParser(generated, prog, rounds);
+    cout << name << ": " << (same ? "一致" : "不一致")
+         << ", 节点数 " << expectedTree->size()
+         << ", 表驱动 " << tableMs << " ms, 递归下降 " << generatedMs << " ms" << endl;
+    return same;
+}
+
+int main(int argc, char* argv[]) {
+    if (cSubsetGrammar().hash != GeneratedParser::GRAMMAR_HASH) {
+        cerr << "GeneratedParser.h与当前文法不符，请执行make重新生成" << endl;
+        return 1;
+    }
+
+    if (argc > 1 && string(argv[1]) == "--print") {
+        string prog;
+        read_prog(prog);
+        GeneratedParser parser;
+        parser.parse(prog).print();
+        return 0;
+    }
+    bool withGenerated = argc > 1 && string(argv[1]) == "--generated";
+    int first = withGenerated ? 2 : 1;
+    if (!withGenerated && argc < 2) {
+        cerr << "用法: " << argv[0] << " [--generated] 程序文件... | --print" << endl;
+        return 2;
+    }
+
+    LLParser tableDriven;
+    GeneratedParser generated;
+    int failed = 0;
+    if (withGenerated) {
+        vector<pair<string, string>> inputs = generatedInputs();
+        for (size_t i = 0; i < inputs.size(); i++) {
+            if (!compare(inputs[i].first, inputs[i].second, tableDriven, generated)) failed++;
+        }
+    }
+    for (int i = first; i < argc; i++) {
+        string prog;
+        if (!readFile(argv[i], prog)) {
+            cerr << "无法读取: " << argv[i] << endl;
+            failed++;
+            continue;
+        }
+        if (!compare(argv[i], prog, tableDriven, generated)) failed++;
+    }
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,313 @@
+// 递归下降分析器生成器
+// 根据文法和LL(1)分析表生成专用的C++递归下降分析器：每个非终结符一个函数，
+// 预测时对token种类做一次switch，建树和错误恢复直接写在各分支中
+// 另外可以只输出FIRST/FOLLOW集和分析表的静态数组，供LLParser启动时直接使用
+// 用法：./rd_generator 输出文件 [文法文件]
+//       ./rd_generator --tables 输出文件 [文法文件]
+// 不指定文法时使用内置的C语言子集文法
+
+#include "../LLparser.h"
+
+// TokenKind各枚举值的名称，用作生成代码中的case标号
+const char* tokenKindEnumName(int kind) {
+    static const char* const names[TOKEN_KIND_COUNT] = {
+        "TK_LBRACE", "TK_RBRACE", "TK_LPAREN", "TK_RPAREN", "TK_SEMI", "TK_ASSIGN",
+        "TK_LT", "TK_GT", "TK_LE", "TK_GE", "TK_EQ",
+        "TK_PLUS", "TK_MINUS", "TK_MUL", "TK_DIV",
+        "TK_IF", "TK_THEN", "TK_ELSE", "TK_WHILE", "TK_ID", "TK_NUM",
+        "TK_END"
+    };
+    return names[kind];
+}
+
+class RecursiveDescentGenerator {
+private:
+    const GrammarFile& file;
+    Grammar grammar;
+    ParseTable table;
+    vector<string> functionNames;       // 非终结符下标 -> 生成的函数名
+    ostringstream out;
+
+    // 把符号名转换为合法的C++标识符
+    static string identifier(const string& name) {
+        string result;
+        for (char c : name) {
+            result += isalnum((unsigned char)c) ? c : '_';
+        }
+        return result;
+    }
+
+    // 符号编号，附带符号名注释
+    string symbolLiteral(int symbol) const {
+        if (symbol < TOKEN_KIND_COUNT) return tokenKindEnumName(symbol);
+        return to_string(symbol) + " /* " + grammar.symbolName(symbol) + " */";
+    }
+
+    const string& functionOf(int nonTerminal) const {
+        return functionNames[nonTerminal - TOKEN_KIND_COUNT];
+    }
+
+    void emitCaseLabels(const vector<int>& kinds, const string& indent) {
+        for (int k : kinds) {
+            out << indent << "case " << tokenKindEnumName(k) << ":\n";
+        }
+    }
+
+    // 生成产生式体：依次匹配终结符、调用非终结符的函数
+    // 产生式以左部自身结尾时（右递归），最后一次调用改为在循环中继续，不再加深调用栈
+    void emitProduction(int nonTerminal, int p, const string& indent) {
+        const Production& prod = grammar.productionList[p];
+        const int* body = &grammar.productionSymbols[prod.begin];
+        if (prod.length == 0) {
+            out << indent << "tree.appendNode(node, " << symbolLiteral(grammar.epsilonId) << ");\n";
+            out << indent << "return;\n";
+            return;
+        }
+        for (int k = 0; k < prod.length; k++) {
+            int symbol = body[k];
+            if (grammar.isNonTerminal(symbol)) {
+                if (k == prod.length - 1 && symbol == nonTerminal) {
+                    out << indent << "node = tree.appendNode(node, " << symbolLiteral(symbol) << ");\n";
+                    out << indent << "continue;\n";
+                    return;
+                }
+                out << indent << functionOf(symbol) << "(tree.appendNode(node, "
+                    << symbolLiteral(symbol) << "));\n";
+            } else if (k == 0) {
+                // 以终结符开头的产生式只会由该终结符选中，无需再比较
+                out << indent << "tree.appendNode(node, " << symbolLiteral(symbol) << ");\n";
+                out << indent << "advance();\n";
+            } else {
+                out << indent << "match(" << symbolLiteral(symbol) << ", node);\n";
+            }
+        }
+        out << indent << "return;\n";
+    }
+
+    void emitFunction(int nonTerminal) {
+        int n = nonTerminal - TOKEN_KIND_COUNT;
+        out << "    // " << grammar.symbolName(nonTerminal) << " ->";
+        for (size_t i = 0; i < grammar.productionsOf[n].size(); i++) {
+            const Production& prod = grammar.productionList[grammar.productionsOf[n][i]];
+            out << (i > 0 ? " |" : "");
+            for (int k = 0; k < prod.length; k++) {
+                out << " " << grammar.symbolName(grammar.productionSymbols[prod.begin + k]);
+            }
+            if (prod.length == 0) out << " E";
+        }
+        out << "\n";
+        out << "    void " << functionOf(nonTerminal) << "(int node) {\n";
+        out << "        DepthGuard guard(depth);\n";
+        out << "        if (depth > MAX_DEPTH) return abandon();\n";
+        out << "        for (;;) {\n";
+        out << "            switch (lookahead.kind) {\n";
+
+        // 按产生式归并分析表中的表项；其余向前看符号按错误恢复策略分为两类
+        vector<int> recoverEpsilon, recoverSkip;
+        map<int, vector<int>> byProduction;
+        for (int t = 0; t < TOKEN_KIND_COUNT; t++) {
+            int p = table.lookup(nonTerminal, t);
+            if (p >= 0) {
+                byProduction[p].push_back(t);
+            } else if (table.recoversWithEpsilon(nonTerminal, t)) {
+                recoverEpsilon.push_back(t);
+            } else {
+                recoverSkip.push_back(t);
+            }
+        }
+        for (int p : grammar.productionsOf[n]) {
+            if (byProduction.count(p) == 0) continue;
+            emitCaseLabels(byProduction[p], "            ");
+            emitProduction(nonTerminal, p, "                ");
+        }
+        // 没有需要跳过token的向前看符号时（可空的非终结符），空产生式恢复直接作为default
+        if (!recoverEpsilon.empty()) {
+            out << "            // 错误恢复：按空产生式处理\n";
+            if (recoverSkip.empty()) {
+                out << "            default:\n";
+            } else {
+                emitCaseLabels(recoverEpsilon, "            ");
+            }
+            out << "                tree.appendNode(node, " << symbolLiteral(grammar.epsilonId) << ");\n";
+            out << "                return;\n";
+        }
+        if (!recoverSkip.empty()) {
+            out << "            default:\n";
+            out << "                // 错误恢复：跳过当前token后重试\n";
+            out << "                advance();\n";
+            out << "                if (lookahead.kind == TK_END) return;\n";
+        }
+        out << "            }\n";
+        out << "        }\n";
+        out << "    }\n\n";
+    }
+
+public:
+    explicit RecursiveDescentGenerator(const GrammarFile& f) : file(f), grammar(f), table(grammar) {
+        grammar.computeFirstFollow();
+        table.buildTable();
+        set<string> used;
+        for (int nt = TOKEN_KIND_COUNT; nt < grammar.epsilonId; nt++) {
+            string name = "parse_" + identifier(grammar.symbolName(nt));
+            if (!used.insert(name).second) name += "_" + to_string(nt);
+            functionNames.push_back(name);
+        }
+    }
+
+    // 生成的分析器和静态分析表都只能表示LL(1)文法，有冲突表项时需要LLParser的自适应预测
+    bool isLL1() const {
+        return table.conflicts.empty();
+    }
+
+    // 输出FIRST/FOLLOW集（FirstFollowEngine::saveState()的格式）和分析表的常量数组
+    // 数组只含常量初始化，编译后位于只读数据段，程序启动时不需要任何计算
+    string generateTables() {
+        out.str("");
+        vector<uint64_t> state = grammar.analysis.saveState();
+        out << "// 由rd_generator --tables根据common/c_subset.bnf生成的LL(1)分析结果，请勿手工修改\n";
+        out << "// 重新生成：cd lab_2/rd_generator && make tables\n";
+        out << "// LLParser的文法散列与C_SUBSET_LL1_HASH相同时直接使用这些数组，不同时忽略本文件\n";
+        out << "#ifndef C_SUBSET_LL1_H\n";
+        out << "#define C_SUBSET_LL1_H\n\n";
+        out << "#include <cstdint>\n\n";
+        out << "static const uint64_t C_SUBSET_LL1_HASH = 0x" << hex << file.hash << dec << "ULL;\n\n";
+        out << "// 每个符号依次为：可空标记、FIRST集的位、FOLLOW集的位\n";
+        out << "static const uint64_t C_SUBSET_LL1_STATE[" << state.size() << "] = {\n";
+        for (size_t i = 0; i < state.size(); i++) {
+            out << (i % 6 == 0 ? "    " : " ") << "0x" << hex << state[i] << dec << "ULL,";
+            if (i % 6 == 5 || i + 1 == state.size()) out << "\n";
+        }
+        out << "};\n\n";
+        out << "// 分析表：每行一个非终结符，每列一个终结符（TokenKind顺序），-1表示无对应表项\n";
+        out << "static const int16_t C_SUBSET_LL1_TABLE[" << table.table.size() << "] = {\n";
+        for (int nt = TOKEN_KIND_COUNT; nt < grammar.epsilonId; nt++) {
+            out << "   ";
+            for (int t = 0; t < TOKEN_KIND_COUNT; t++) {
+                out << " " << table.lookup(nt, t) << ",";
+            }
+            out << "  // " << grammar.symbolName(nt) << "\n";
+        }
+        out << "};\n\n";
+        out << "#endif\n";
+        return out.str();
+    }
+
+    string generate() {
+        out.str("");
+        out << "// 由rd_generator根据文法生成的递归下降分析器，请勿手工修改\n";
+        out << "// 重新生成：make GeneratedParser.h\n";
+        out << "#ifndef GENERATED_PARSER_H\n";
+        out << "#define GENERATED_PARSER_H\n\n";
+        out << "#include \"../LLparser.h\"\n\n";
+        out << "class GeneratedParser {\n";
+        out << "public:\n";
+        out << "    // 生成时所用文法的散列值，与运行时文法不同说明需要重新生成\n";
+        out << "    static const uint64_t GRAMMAR_HASH = 0x" << hex << file.hash << dec << "ULL;\n\n";
+        out << "    // 非终结符函数的最大嵌套层数（每层{ }或括号约三层），超过时改用LLParser的显式分析栈，\n";
+        out << "    // 不会因输入嵌套过深而栈溢出\n";
+        out << "    enum { MAX_DEPTH = 30000 };\n\n";
+        out << "private:\n";
+        out << "    GrammarFile file;           // 嵌套过深时构造LLParser用\n";
+        out << "    Grammar grammar;            // 只用于输出语法树时取得符号名\n";
+        out << "    Lexer lexer;                // 按需产生token\n";
+        out << "    Token lookahead;            // 当前token\n";
+        out << "    int prevTokenLine;          // 前一个token的行号，还没有时为-1\n";
+        out << "    vector<string> errors;\n";
+        out << "    int lastErrorLine;\n";
+        out << "    ParseTree tree;\n";
+        out << "    int depth;                  // 当前非终结符函数的嵌套层数\n";
+        out << "    bool tooDeep;               // 本次分析是否因嵌套过深而放弃\n";
+        out << "    unique_ptr<LLParser> fallback;  // 嵌套过深时使用的表驱动分析器，第一次用到时构造\n\n";
+        out << "    // 进入非终结符函数时增加嵌套层数，返回时恢复\n";
+        out << "    struct DepthGuard {\n";
+        out << "        int& depth;\n";
+        out << "        explicit DepthGuard(int& d) : depth(d) { depth++; }\n";
+        out << "        ~DepthGuard() { depth--; }\n";
+        out << "    };\n\n";
+        out << "    // 放弃本次分析：把当前token置为输入结束，各层函数随即返回，由parse()改用LLParser\n";
+        out << "    void abandon() {\n";
+        out << "        tooDeep = true;\n";
+        out << "        lookahead.kind = TK_END;\n";
+        out << "    }\n\n";
+        out << "    void advance() {\n";
+        out << "        if (lookahead.kind != TK_END) {\n";
+        out << "            prevTokenLine = lookahead.line;\n";
+        out << "            lexer.next(lookahead);\n";
+        out << "        }\n";
+        out << "    }\n\n";
+        out << "    // 匹配终结符，缺少时报错并插入该终结符（与LLParser::handleMissingTerminal相同）\n";
+        out << "    void match(int expected, int parent) {\n";
+        out << "        if (lookahead.kind == expected) {\n";
+        out << "            tree.appendNode(parent, expected);\n";
+        out << "            advance();\n";
+        out << "            return;\n";
+        out << "        }\n";
+        out << "        int line = prevTokenLine >= 0 ? prevTokenLine : lookahead.line;\n";
+        out << "        if (line != lastErrorLine || errors.empty()) {\n";
+        out << "            errors.push_back(\"语法错误,第\" + to_string(line) + \"行,缺少\\\"\" + tokenKindName(expected) + \"\\\"\");\n";
+        out << "            lastErrorLine = line;\n";
+        out << "        }\n";
+        out << "        tree.appendNode(parent, expected);\n";
+        out << "    }\n\n";
+        for (int nt = TOKEN_KIND_COUNT; nt < grammar.epsilonId; nt++) {
+            emitFunction(nt);
+        }
+        out << "public:\n";
+        out << "    GeneratedParser(const GrammarFile& f = cSubsetGrammar())\n";
+        out << "        : file(f), grammar(f), prevTokenLine(-1), lastErrorLine(-1), tree(grammar),\n";
+        out << "          depth(0), tooDeep(false) {}\n\n";
+        out << "    // 与LLParser::parse()相同：先输出错误信息，返回的语法树在下一次调用前有效\n";
+        out << "    const ParseTree& parse(const string& prog) {\n";
+        out << "        lexer.reset(prog);\n";
+        out << "        lexer.next(lookahead);\n";
+        out << "        prevTokenLine = -1;\n";
+        out << "        errors.clear();\n";
+        out << "        lastErrorLine = -1;\n";
+        out << "        depth = 0;\n";
+        out << "        tooDeep = false;\n";
+        out << "        tree.clear();\n";
+        out << "        tree.reserve(prog.size() * 3 / 2 + 1);\n";
+        out << "        tree.root = tree.newNode(" << symbolLiteral(grammar.startId) << ");\n";
+        out << "        " << functionOf(grammar.startId) << "(tree.root);\n";
+        out << "        if (tooDeep) {\n";
+        out << "            // 已产生的错误信息和语法树作废，由LLParser重新分析并输出\n";
+        out << "            if (!fallback) fallback.reset(new LLParser(file));\n";
+        out << "            return fallback->parse(prog);\n";
+        out << "        }\n";
+        out << "        for (const auto& err : errors) {\n";
+        out << "            cout << err << endl;\n";
+        out << "        }\n";
+        out << "        return tree;\n";
+        out << "    }\n";
+        out << "};\n\n";
+        out << "#endif\n";
+        return out.str();
+    }
+};
+
+int main(int argc, char* argv[]) {
+    bool tablesOnly = argc > 1 && string(argv[1]) == "--tables";
+    int first = tablesOnly ? 2 : 1;
+    if (argc <= first) {
+        cerr << "用法: " << argv[0] << " [--tables] 输出文件 [文法文件]" << endl;
+        return 2;
+    }
+    GrammarFile grammar;
+    if (argc > first + 1 && !grammar.load(argv[first + 1])) {
+        cerr << grammar.error << endl;
+        return 1;
+    }
+
+    RecursiveDescentGenerator generator(argc > first + 1 ? grammar : cSubsetGrammar());
+    if (!generator.isLL1()) {
+        cerr << "文法不是LL(1)文法（分析表有冲突表项），无法生成" << endl;
+        return 1;
+    }
+    ofstream out(argv[first]);
+    out << (tablesOnly ? generator.generateTables() : generator.generate());
+    if (!out) {
+        cerr << "无法写入: " << argv[first] << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -6,6 +6,9 @@
 #include <string>
 #include <vector>
 #include <queue>
+#include "../../common/AnalysisCache.h"
+#include "../../common/FirstFollow.h"
+#include "../../common/GrammarFile.h"
 using namespace std;
 
 // ==================== 符号类 ====================
@@ -54,71 +57,63 @@ private:
     Symbol augmentedStart;
     map<Symbol, set<Symbol>> firstSet;
     map<Symbol, set<Symbol>> followSet;
+    vector<Symbol> symbolList;      // 编号 -> 符号（终结符在前）
+    map<Symbol, int> symbolId;      // 符号 -> 编号
+    FirstFollowEngine analysis;     // 与LRparser.h相同的FIRST/FOLLOW计算引擎
 
 public:
-    FirstFollowCalculator() {
-        initGrammar();
+    // cachePath为分析缓存文件，为空时每次都重新计算；文法未变时直接读取其中的FIRST/FOLLOW集
+    FirstFollowCalculator(const GrammarFile& file, const string& cachePath = "") {
+        initGrammar(file);
+        internSymbols();
+
+        AnalysisCache cache;
+        string data;
+        if (!cachePath.empty() && cache.load(cachePath, file.hash) && cache.get("ff", data)) {
+            CacheReader reader(data);
+            vector<uint64_t> state;
+            analysis = FirstFollowEngine(terminals.size(), nonTerminals.size());
+            if (reader.getArray(state) && reader.atEnd() && analysis.restoreState(state)) {
+                exportFirstSets();
+                computeFollowSets();
+                return;
+            }
+        }
         computeFirstSets();
         computeFollowSets();
+        if (!cachePath.empty()) {
+            CacheWriter writer;
+            writer.putArray(analysis.saveState());
+            cache.put("ff", writer.data);
+            cache.save(cachePath);
+        }
     }
 
-    // 初始化文法（与LRparser.h中相同）
-    void initGrammar() {
-        // 定义终结符
-        vector<string> termNames = {
-            "{", "}", "if", "(", ")", "then", "else", "while",
-            "ID", "=", ";", "<", ">", "<=", ">=", "==",
-            "+", "-", "*", "/", "NUM", "$"
-        };
-        for (const string& t : termNames) {
+    // 从文法文件初始化文法（与LRparser.h中相同，文法见common/c_subset.bnf）
+    void initGrammar(const GrammarFile& file) {
+        for (const string& t : file.terminals()) {
             terminals.insert(Symbol(t, true));
         }
+        terminals.insert(Symbol("$", true));
 
-        // 定义非终结符
-        vector<string> nonTermNames = {
-            "program'", "program", "stmt", "compoundstmt", "stmts",
-            "ifstmt", "whilestmt", "assgstmt", "boolexpr", "boolop",
-            "arithexpr", "arithexprprime", "multexpr", "multexprprime", "simpleexpr"
-        };
-        for (const string& nt : nonTermNames) {
-            nonTerminals.insert(Symbol(nt, false));
-        }
+        startSymbol = Symbol(file.startSymbol(), false);
+        augmentedStart = Symbol(file.startSymbol() + "'", false);
 
-        startSymbol = Symbol("program", false);
-        augmentedStart = Symbol("program'", false);
+        nonTerminals.insert(augmentedStart);
+        for (const GrammarRule& rule : file.rules) {
+            nonTerminals.insert(Symbol(rule.lhs, false));
+        }
 
         int prodId = 0;
-        addProduction("program'", {"program"}, prodId++);
-        addProduction("program", {"compoundstmt"}, prodId++);
-        addProduction("stmt", {"ifstmt"}, prodId++);
-        addProduction("stmt", {"whilestmt"}, prodId++);
-        addProduction("stmt", {"assgstmt"}, prodId++);
-        addProduction("stmt", {"compoundstmt"}, prodId++);
-        addProduction("compoundstmt", {"{", "stmts", "}"}, prodId++);
-        addProduction("stmts", {"stmt", "stmts"}, prodId++);
-        addProduction("stmts", {"E"}, prodId++);
-        addProduction("ifstmt", {"if", "(", "boolexpr", ")", "then", "stmt", "else", "stmt"}, prodId++);
-        addProduction("whilestmt", {"while", "(", "boolexpr", ")", "stmt"}, prodId++);
-        addProduction("assgstmt", {"ID", "=", "arithexpr", ";"}, prodId++);
-        addProduction("boolexpr", {"arithexpr", "boolop", "arithexpr"}, prodId++);
-        addProduction("boolop", {"<"}, prodId++);
-        addProduction("boolop", {">"}, prodId++);
-        addProduction("boolop", {"<="}, prodId++);
-        addProduction("boolop", {">="}, prodId++);
-        addProduction("boolop", {"=="}, prodId++);
-        addProduction("arithexpr", {"multexpr", "arithexprprime"}, prodId++);
-        addProduction("arithexprprime", {"+", "multexpr", "arithexprprime"}, prodId++);
-        addProduction("arithexprprime", {"-", "multexpr", "arithexprprime"}, prodId++);
-        addProduction("arithexprprime", {"E"}, prodId++);
-        addProduction("multexpr", {"simpleexpr", "multexprprime"}, prodId++);
-        addProduction("multexprprime", {"*", "simpleexpr", "multexprprime"}, prodId++);
-        addProduction("multexprprime", {"/", "simpleexpr", "multexprprime"}, prodId++);
-        addProduction("multexprprime", {"E"}, prodId++);
-        addProduction("simpleexpr", {"ID"}, prodId++);
-        addProduction("simpleexpr", {"NUM"}, prodId++);
-        addProduction("simpleexpr", {"(", "arithexpr", ")"}, prodId++);
+        addProduction(augmentedStart.name, {startSymbol.name}, prodId++);
+        for (const GrammarRule& rule : file.rules) {
+            for (const vector<string>& body : rule.alternatives) {
+                addProduction(rule.lhs, body, prodId++);
+            }
+        }
     }
 
+
     // 添加产生式
     void addProduction(const string& left, const vector<string>& right, int id) {
         Symbol leftSym(left, false);
@@ -130,121 +125,59 @@ public:
         productions.push_back(Production(leftSym, rightSyms, id));
     }
 
-    // 计算FIRST集
-    void computeFirstSets() {
-        // 终结符的FIRST集是其自身
-        for (const Symbol& t : terminals) {
-            firstSet[t].insert(t);
-        }
-        Symbol epsilon("E", true);
-        firstSet[epsilon].insert(epsilon);
-
-        // 迭代计算非终结符的FIRST集
-        bool changed = true;
-        while (changed) {
-            changed = false;
-            for (const Production& prod : productions) {
-                set<Symbol>& first = firstSet[prod.left];
-                size_t oldSize = first.size();
-
-                bool allHaveEpsilon = true;
-                for (const Symbol& sym : prod.right) {
-                    if (sym.name == "E") {
-                        first.insert(Symbol("E", true));
-                        break;
-                    }
-
-                    for (const Symbol& f : firstSet[sym]) {
-                        if (f.name != "E") {
-                            first.insert(f);
-                        }
-                    }
-
-                    if (firstSet[sym].find(Symbol("E", true)) == firstSet[sym].end()) {
-                        allHaveEpsilon = false;
-                        break;
-                    }
-                }
-
-                if (allHaveEpsilon && !prod.right.empty() && prod.right[0].name != "E") {
-                    first.insert(Symbol("E", true));
-                }
-
-                if (first.size() != oldSize) {
-                    changed = true;
-                }
-            }
-        }
-    }
-
-    // 计算符号串的FIRST集
-    set<Symbol> getFirstOfString(const vector<Symbol>& symbols, int start) {
+    // 由位集转换为符号集合，nullable为真时加入ε
+    set<Symbol> toSymbolSet(const TerminalSet& bits, bool nullable) {
         set<Symbol> result;
-        if (start >= (int)symbols.size()) {
+        bits.forEach([&](int t) {
+            result.insert(symbolList[t]);
+        });
+        if (nullable) {
             result.insert(Symbol("E", true));
-            return result;
         }
+        return result;
+    }
 
-        bool allHaveEpsilon = true;
-        for (int i = start; i < (int)symbols.size(); i++) {
-            const Symbol& sym = symbols[i];
-            if (sym.name == "E") {
-                result.insert(Symbol("E", true));
-                break;
-            }
-
-            for (const Symbol& f : firstSet[sym]) {
-                if (f.name != "E") {
-                    result.insert(f);
-                }
-            }
+    // 符号编号：终结符在前，与LRparser.h相同
+    void internSymbols() {
+        for (const Symbol& t : terminals) {
+            symbolId[t] = symbolList.size();
+            symbolList.push_back(t);
+        }
+        for (const Symbol& nt : nonTerminals) {
+            symbolId[nt] = symbolList.size();
+            symbolList.push_back(nt);
+        }
+    }
 
-            if (firstSet[sym].find(Symbol("E", true)) == firstSet[sym].end()) {
-                allHaveEpsilon = false;
-                break;
+    // 计算FIRST集（同时由引擎求出可空性和FOLLOW集）
+    void computeFirstSets() {
+        analysis = FirstFollowEngine(terminals.size(), nonTerminals.size());
+        for (const Production& prod : productions) {
+            vector<int> body;
+            for (const Symbol& sym : prod.right) {
+                if (sym.name != "E") body.push_back(symbolId.at(sym));
             }
+            analysis.addProduction(symbolId.at(prod.left), body);
         }
+        int end = symbolId.at(Symbol("$", true));
+        analysis.addFollow(symbolId.at(augmentedStart), end);
+        analysis.addFollow(symbolId.at(startSymbol), end);
+        analysis.compute();
+        exportFirstSets();
+    }
 
-        if (allHaveEpsilon) {
-            result.insert(Symbol("E", true));
+    // 由引擎的结果导出各非终结符的FIRST集
+    void exportFirstSets() {
+        for (const Symbol& nt : nonTerminals) {
+            int id = symbolId.at(nt);
+            firstSet[nt] = toSymbolSet(analysis.first(id), analysis.isNullable(id));
         }
-
-        return result;
     }
 
     // 计算FOLLOW集
     void computeFollowSets() {
-        followSet[augmentedStart].insert(Symbol("$", true));
-        followSet[startSymbol].insert(Symbol("$", true));
-
-        bool changed = true;
-        while (changed) {
-            changed = false;
-            for (const Production& prod : productions) {
-                for (int i = 0; i < (int)prod.right.size(); i++) {
-                    const Symbol& B = prod.right[i];
-                    if (B.isTerminal || B.name == "E") continue;
-
-                    size_t oldSize = followSet[B].size();
-                    set<Symbol> firstBeta = getFirstOfString(prod.right, i + 1);
-
-                    for (const Symbol& f : firstBeta) {
-                        if (f.name != "E") {
-                            followSet[B].insert(f);
-                        }
-                    }
-
-                    if (firstBeta.find(Symbol("E", true)) != firstBeta.end()) {
-                        for (const Symbol& f : followSet[prod.left]) {
-                            followSet[B].insert(f);
-                        }
-                    }
-
-                    if (followSet[B].size() != oldSize) {
-                        changed = true;
-                    }
-                }
-            }
+        for (const Symbol& nt : nonTerminals) {
+            followSet[nt] = toSymbolSet(analysis.follow(symbolId.at(nt)), false);
         }
     }
 
@@ -304,11 +237,19 @@ public:
     }
 };
 
-int main() {
+// 用法：./first_follow [文法文件]，不指定时使用实验二、三共用的C语言子集文法
+// 分析缓存默认为可执行文件旁边的first_follow.gcache，可用环境变量GRAMMAR_CACHE指定
+int main(int argc, char* argv[]) {
+    GrammarFile grammar;
+    if (argc > 1 && !grammar.load(argv[1])) {
+        cerr << grammar.error << endl;
+        return 1;
+    }
+
     cout << "LR(1)语法分析器 - FIRST/FOLLOW集计算工具" << endl;
     cout << "==========================================" << endl << endl;
 
-    FirstFollowCalculator calc;
+    FirstFollowCalculator calc(argc > 1 ? grammar : cSubsetGrammar(), defaultCachePath());
     calc.printProductions();
     calc.printFirstSets();
     calc.printFollowSets();
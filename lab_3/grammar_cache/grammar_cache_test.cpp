@@ -0,0 +1,122 @@
+// 文法文件与分析缓存测试程序
+// 测试BNF文法文件的解析和错误报告、文法散列、缓存文件的读写与校验，
+// 以及LRParser从缓存启动与重新计算的分析结果完全相同
+
+#include "../LRparser.h"
+#include "../../common/test_util.h"
+
+/* 用给定的文法和缓存分析程序，返回输出的错误信息和推导过程 */
+string analyzeWith(const GrammarFile& grammar, const string& cachePath, const string& prog) {
+    return captureOutput([&] {
+        LRParser parser(grammar, cachePath);
+        parser.analyze(prog);
+    });
+}
+
+void testGrammarFile() {
+    cout << "\n=== 文法文件 ===" << endl;
+    const GrammarFile& g = cSubsetGrammar();
+    size_t alternatives = 0;
+    for (size_t i = 0; i < g.rules.size(); i++) alternatives += g.rules[i].alternatives.size();
+    check(g.error.empty() && g.rules.size() == 14 && alternatives == 28, "内置文法：14个非终结符、28个候选式");
+    check(g.startSymbol() == "program" && g.terminals().size() == 21, "起始符号和终结符");
+    check(g.rules[3].lhs == "stmts" && g.rules[3].alternatives[1] == vector<string>(1, "E"), "空串候选式");
+    check(g.rules[10].alternatives.size() == 3, "以|开头的续行");
+
+    GrammarFile file;
+    check(file.load("../../common/c_subset.bnf") && file.hash == g.hash, "从文件读取与内置文法相同");
+
+    GrammarFile a, b, c;
+    a.parse("S -> a S | E\n");
+    b.parse("# 注释\n  S ->   a S\n     | E   # 行尾注释\n\n");
+    c.parse("S -> a S | b\n");
+    check(a.hash == b.hash, "注释和空白不影响散列");
+    check(a.hash != c.hash, "规则改变时散列改变");
+
+    GrammarFile d;
+    d.parse("S -> a\nT -> b\nS -> c\n");
+    check(d.rules.size() == 2 && d.rules[0].alternatives.size() == 2, "同一左部的规则合并");
+
+    const char* bad[] = {"S a b\n", "S -> a |\n", "S -> a E\n", "| a\n", "# 空文法\n", "E -> a\n", "S -> a -> b\n"};
+    bool allRejected = true;
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        GrammarFile e;
+        allRejected = allRejected && !e.parse(bad[i]) && !e.error.empty() && e.rules.empty();
+    }
+    check(allRejected, "格式错误的文法被拒绝并给出原因");
+
+    GrammarFile missing;
+    check(!missing.load("no_such.bnf") && !missing.error.empty(), "文件不存在");
+}
+
+void testCacheFile() {
+    cout << "\n=== 缓存文件 ===" << endl;
+    AnalysisCache cache;
+    check(!cache.load("test.gcache", 42), "缓存文件不存在");
+    cache.put("a", string("\0\1\2", 3));
+    cache.put("b", "");
+    check(cache.save("test.gcache"), "写入缓存");
+
+    AnalysisCache loaded;
+    string data;
+    check(loaded.load("test.gcache", 42) && loaded.get("a", data) && data == string("\0\1\2", 3) &&
+          loaded.get("b", data) && data.empty() && !loaded.get("c", data), "读回各区段");
+    check(!loaded.load("test.gcache", 43) && !loaded.get("a", data), "文法散列不同时缓存作废");
+    check(!loaded.load("test.gcache", 42, analysisRevision + 1) && !loaded.get("a", data),
+          "分析器修订号不同时缓存作废");
+
+    string content = readFile("test.gcache");
+    writeFile("test.gcache", content.substr(0, content.size() - 1));
+    check(!loaded.load("test.gcache", 42), "截断的缓存被拒绝");
+    writeFile("test.gcache", content + "x");
+    check(!loaded.load("test.gcache", 42), "多余的数据被拒绝");
+    writeFile("test.gcache", "garbage");
+    check(!loaded.load("test.gcache", 42), "文件头错误被拒绝");
+}
+
+void testParserCache() {
+    cout << "\n=== 从缓存启动LRParser ===" << endl;
+    const char* programs[] = {
+        "{\nID = NUM ;\n}",
+        "{\nwhile ( ID == NUM )\n{\nID = ID + NUM * ( ID - NUM ) ;\n}\n}",
+        "{\nif ( ID < NUM ) then ID = NUM ; else ID = ID ;\n}",
+        "{\nID = NUM\n}",
+        "{\nif ( ID > NUM ) ID = NUM ; else ID = NUM ;\n}"
+    };
+    remove("test.gcache");
+    bool same = true;
+    for (size_t i = 0; i < sizeof(programs) / sizeof(programs[0]); i++) {
+        string expected = analyzeWith(cSubsetGrammar(), "", programs[i]);
+        same = same && analyzeWith(cSubsetGrammar(), "test.gcache", programs[i]) == expected;
+    }
+    check(same, "读取缓存与重新计算的输出相同（含错误恢复）");
+
+    AnalysisCache cache;
+    string data;
+    check(cache.load("test.gcache", cSubsetGrammar().hash) && cache.get("lr1", data), "缓存中有lr1区段");
+
+    // 损坏的区段被丢弃，重新计算后写回
+    cache.put("lr1", "bad");
+    cache.save("test.gcache");
+    check(analyzeWith(cSubsetGrammar(), "test.gcache", programs[1]) ==
+          analyzeWith(cSubsetGrammar(), "", programs[1]), "损坏的区段被重新计算");
+    check(cache.load("test.gcache", cSubsetGrammar().hash) && cache.get("lr1", data) && data != "bad",
+          "重新计算的结果写回缓存");
+
+    // 换一个文法，缓存以新文法的散列重建
+    GrammarFile other;
+    other.parse("program -> { stmts }\nstmts -> ID = NUM ; stmts | E\n");
+    string output = analyzeWith(other, "test.gcache", "{ ID = NUM ; ID = NUM ; }");
+    check(output.find("program => \n{ stmts }") == 0, "其他文法可以分析");
+    check(cache.load("test.gcache", other.hash) && !cache.load("test.gcache", cSubsetGrammar().hash),
+          "文法改变后缓存以新文法为键");
+}
+
+int main() {
+    testGrammarFile();
+    testCacheFile();
+    testParserCache();
+    remove("test.gcache");
+
+    return testSummary();
+}
@@ -0,0 +1,76 @@
+#!/bin/bash
+# 分析缓存端到端测试脚本
+# 编译实验三的分析器和两个工具，每个程序连续运行两次：
+# 第一次计算后写入缓存，第二次直接读取缓存，输出必须相同且缓存文件不被重写
+# （未命中时总是写临时文件再rename，缓存文件的inode会改变）
+
+cd "$(dirname "$0")"
+LAB3=..
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+PASSED=0
+FAILED=0
+
+check() {
+    if [ "$1" = 0 ]; then
+        PASSED=$((PASSED + 1))
+        echo "✓ $2"
+    else
+        FAILED=$((FAILED + 1))
+        echo "✗ $2"
+    fi
+}
+
+CXXFLAGS="-std=c++11 -O2"
+g++ $CXXFLAGS -o "$WORK/test_parser" $LAB3/test_main.cpp || exit 1
+g++ $CXXFLAGS -o "$WORK/first_follow" $LAB3/first_follow_tool/first_follow.cpp || exit 1
+g++ $CXXFLAGS -o "$WORK/table_visualizer" $LAB3/table_visualizer/table_visualizer.cpp || exit 1
+
+printf '{\nwhile ( ID == NUM )\n{\nID = NUM\n}\n}' > "$WORK/input.txt"
+
+# 用法：run_twice 名称 命令...；GRAMMAR_CACHE由调用者设置
+run_twice() {
+    local name=$1
+    shift
+    "$@" < "$WORK/input.txt" > "$WORK/$name.out1" 2>&1
+    [ -f "$CACHE" ]
+    check $? "$name: 第一次运行写入缓存文件"
+    local inode=$(stat -c %i "$CACHE" 2>/dev/null)
+
+    "$@" < "$WORK/input.txt" > "$WORK/$name.out2" 2>&1
+    [ "$(stat -c %i "$CACHE" 2>/dev/null)" = "$inode" ]
+    check $? "$name: 第二次运行从缓存读取，缓存文件未被重写"
+    cmp -s "$WORK/$name.out1" "$WORK/$name.out2"
+    check $? "$name: 两次运行的输出相同"
+}
+
+echo "=== 环境变量GRAMMAR_CACHE指定缓存文件 ==="
+for prog in test_parser first_follow table_visualizer; do
+    export GRAMMAR_CACHE="$WORK/$prog.cache"
+    CACHE=$GRAMMAR_CACHE
+    run_twice $prog "$WORK/$prog"
+done
+
+echo "=== 不使用缓存与使用缓存的输出相同 ==="
+for prog in test_parser first_follow table_visualizer; do
+    GRAMMAR_CACHE= "$WORK/$prog" < "$WORK/input.txt" > "$WORK/$prog.nocache" 2>&1
+    cmp -s "$WORK/$prog.nocache" "$WORK/$prog.out1"
+    check $? "$prog: GRAMMAR_CACHE为空时重新计算，输出相同"
+done
+
+echo "=== 默认缓存文件 ==="
+unset GRAMMAR_CACHE
+CACHE="$WORK/test_parser.gcache"
+run_twice default "$WORK/test_parser"
+
+echo "=== 损坏的缓存 ==="
+export GRAMMAR_CACHE="$WORK/broken.cache"
+head -c 100 "$CACHE" > "$GRAMMAR_CACHE"
+"$WORK/test_parser" < "$WORK/input.txt" > "$WORK/broken.out" 2>&1
+cmp -s "$WORK/broken.out" "$WORK/default.out1" && [ "$(stat -c %s "$GRAMMAR_CACHE")" = "$(stat -c %s "$CACHE")" ]
+check $? "截断的缓存被重新计算并写回"
+
+echo ""
+echo "通过: $PASSED, 失败: $FAILED"
+[ $FAILED = 0 ]
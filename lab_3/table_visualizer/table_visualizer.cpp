@@ -7,6 +7,8 @@
 #include <string>
 #include <vector>
 #include <queue>
+#include "../../common/AnalysisCache.h"
+#include "../../common/GrammarFile.h"
 using namespace std;
 
 // ==================== 符号类 ====================
@@ -120,73 +122,55 @@ private:
     map<Symbol, set<Symbol>> firstSet;
     map<Symbol, set<Symbol>> followSet;
     vector<LR1State> states;
+    int stateCount;                 // 状态数量，从缓存恢复时states为空
     map<pair<int, Symbol>, int> gotoTable;
     map<pair<int, Symbol>, int> actionTable;
 
 public:
-    TableVisualizer() {
-        initGrammar();
+    // cachePath为分析缓存文件，为空时每次都重新计算；文法未变时直接读取其中的ACTION/GOTO表
+    TableVisualizer(const GrammarFile& file, const string& cachePath = "") : stateCount(0) {
+        initGrammar(file);
+
+        AnalysisCache cache;
+        if (!cachePath.empty() && cache.load(cachePath, file.hash) && restoreTables(cache)) {
+            return;
+        }
         computeFirstSets();
         computeFollowSets();
         buildLR1Automaton();
         buildParsingTable();
+        stateCount = states.size();
+        if (!cachePath.empty()) {
+            saveTables(cache);
+            cache.save(cachePath);
+        }
     }
 
-    // 初始化文法
-    void initGrammar() {
-        vector<string> termNames = {
-            "{", "}", "if", "(", ")", "then", "else", "while",
-            "ID", "=", ";", "<", ">", "<=", ">=", "==",
-            "+", "-", "*", "/", "NUM", "$"
-        };
-        for (const string& t : termNames) {
+    // 从文法文件初始化文法（与LRparser.h中相同，文法见common/c_subset.bnf）
+    void initGrammar(const GrammarFile& file) {
+        for (const string& t : file.terminals()) {
             terminals.insert(Symbol(t, true));
         }
+        terminals.insert(Symbol("$", true));
 
-        vector<string> nonTermNames = {
-            "program'", "program", "stmt", "compoundstmt", "stmts",
-            "ifstmt", "whilestmt", "assgstmt", "boolexpr", "boolop",
-            "arithexpr", "arithexprprime", "multexpr", "multexprprime", "simpleexpr"
-        };
-        for (const string& nt : nonTermNames) {
-            nonTerminals.insert(Symbol(nt, false));
-        }
+        startSymbol = Symbol(file.startSymbol(), false);
+        augmentedStart = Symbol(file.startSymbol() + "'", false);
 
-        startSymbol = Symbol("program", false);
-        augmentedStart = Symbol("program'", false);
+        nonTerminals.insert(augmentedStart);
+        for (const GrammarRule& rule : file.rules) {
+            nonTerminals.insert(Symbol(rule.lhs, false));
+        }
 
         int prodId = 0;
-        addProduction("program'", {"program"}, prodId++);
-        addProduction("program", {"compoundstmt"}, prodId++);
-        addProduction("stmt", {"ifstmt"}, prodId++);
-        addProduction("stmt", {"whilestmt"}, prodId++);
-        addProduction("stmt", {"assgstmt"}, prodId++);
-        addProduction("stmt", {"compoundstmt"}, prodId++);
-        addProduction("compoundstmt", {"{", "stmts", "}"}, prodId++);
-        addProduction("stmts", {"stmt", "stmts"}, prodId++);
-        addProduction("stmts", {"E"}, prodId++);
-        addProduction("ifstmt", {"if", "(", "boolexpr", ")", "then", "stmt", "else", "stmt"}, prodId++);
-        addProduction("whilestmt", {"while", "(", "boolexpr", ")", "stmt"}, prodId++);
-        addProduction("assgstmt", {"ID", "=", "arithexpr", ";"}, prodId++);
-        addProduction("boolexpr", {"arithexpr", "boolop", "arithexpr"}, prodId++);
-        addProduction("boolop", {"<"}, prodId++);
-        addProduction("boolop", {">"}, prodId++);
-        addProduction("boolop", {"<="}, prodId++);
-        addProduction("boolop", {">="}, prodId++);
-        addProduction("boolop", {"=="}, prodId++);
-        addProduction("arithexpr", {"multexpr", "arithexprprime"}, prodId++);
-        addProduction("arithexprprime", {"+", "multexpr", "arithexprprime"}, prodId++);
-        addProduction("arithexprprime", {"-", "multexpr", "arithexprprime"}, prodId++);
-        addProduction("arithexprprime", {"E"}, prodId++);
-        addProduction("multexpr", {"simpleexpr", "multexprprime"}, prodId++);
-        addProduction("multexprprime", {"*", "simpleexpr", "multexprprime"}, prodId++);
-        addProduction("multexprprime", {"/", "simpleexpr", "multexprprime"}, prodId++);
-        addProduction("multexprprime", {"E"}, prodId++);
-        addProduction("simpleexpr", {"ID"}, prodId++);
-        addProduction("simpleexpr", {"NUM"}, prodId++);
-        addProduction("simpleexpr", {"(", "arithexpr", ")"}, prodId++);
+        addProduction(augmentedStart.name, {startSymbol.name}, prodId++);
+        for (const GrammarRule& rule : file.rules) {
+            for (const vector<string>& body : rule.alternatives) {
+                addProduction(rule.lhs, body, prodId++);
+            }
+        }
     }
 
+
     void addProduction(const string& left, const vector<string>& right, int id) {
         Symbol leftSym(left, false);
         vector<Symbol> rightSyms;
@@ -399,12 +383,70 @@ public:
         }
     }
 
+    // 符号编号：终结符在前，与LRparser.h相同
+    vector<Symbol> symbolList() const {
+        vector<Symbol> symbols(terminals.begin(), terminals.end());
+        symbols.insert(symbols.end(), nonTerminals.begin(), nonTerminals.end());
+        return symbols;
+    }
+
+    // 把状态数量和ACTION/GOTO表存入缓存的"lr1table"区段，表项为(状态, 符号编号, 值)
+    void saveTables(AnalysisCache& cache) const {
+        vector<Symbol> symbols = symbolList();
+        map<Symbol, int> symbolId;
+        for (size_t i = 0; i < symbols.size(); i++) {
+            symbolId[symbols[i]] = i;
+        }
+        CacheWriter writer;
+        writer.put((int32_t)stateCount);
+        const map<pair<int, Symbol>, int>* tables[] = {&actionTable, &gotoTable};
+        for (const map<pair<int, Symbol>, int>* table : tables) {
+            vector<int32_t> entries;
+            for (const auto& entry : *table) {
+                entries.push_back(entry.first.first);
+                entries.push_back(symbolId.at(entry.first.second));
+                entries.push_back(entry.second);
+            }
+            writer.putArray(entries);
+        }
+        cache.put("lr1table", writer.data);
+    }
+
+    // 从缓存的"lr1table"区段恢复，区段不存在或与本文法不符时返回false
+    bool restoreTables(const AnalysisCache& cache) {
+        string data;
+        if (!cache.get("lr1table", data)) return false;
+        CacheReader reader(data);
+        int32_t count;
+        vector<int32_t> entries[2];
+        if (!reader.get(count) || !reader.getArray(entries[0]) ||
+            !reader.getArray(entries[1]) || !reader.atEnd() || count <= 0) {
+            return false;
+        }
+
+        vector<Symbol> symbols = symbolList();
+        map<pair<int, Symbol>, int> restored[2];
+        for (int t = 0; t < 2; t++) {
+            if (entries[t].size() % 3 != 0) return false;
+            for (size_t i = 0; i < entries[t].size(); i += 3) {
+                int symbol = entries[t][i + 1];
+                if (entries[t][i] < 0 || entries[t][i] >= count ||
+                    symbol < 0 || symbol >= (int)symbols.size()) return false;
+                restored[t][make_pair((int)entries[t][i], symbols[symbol])] = entries[t][i + 2];
+            }
+        }
+        stateCount = count;
+        actionTable.swap(restored[0]);
+        gotoTable.swap(restored[1]);
+        return true;
+    }
+
     // 打印ACTION表统计信息
     void printActionTableStats() {
         cout << "========================================" << endl;
         cout << "        ACTION表统计" << endl;
         cout << "========================================" << endl;
-        cout << "状态数量: " << states.size() << endl;
+        cout << "状态数量: " << stateCount << endl;
         cout << "ACTION表项数量: " << actionTable.size() << endl;
 
         int shiftCount = 0, reduceCount = 0, acceptCount = 0;
@@ -484,11 +526,19 @@ public:
     }
 };
 
-int main() {
+// 用法：./table_visualizer [文法文件]，不指定时使用实验二、三共用的C语言子集文法
+// 分析缓存默认为可执行文件旁边的table_visualizer.gcache，可用环境变量GRAMMAR_CACHE指定
+int main(int argc, char* argv[]) {
+    GrammarFile grammar;
+    if (argc > 1 && !grammar.load(argv[1])) {
+        cerr << grammar.error << endl;
+        return 1;
+    }
+
     cout << "LR(1)语法分析器 - ACTION/GOTO表可视化工具" << endl;
     cout << "===========================================" << endl << endl;
 
-    TableVisualizer viz;
+    TableVisualizer viz(argc > 1 ? grammar : cSubsetGrammar(), defaultCachePath());
     viz.printProductions();
     viz.printActionTableStats();
     viz.printGotoTableStats();